@@ -13,6 +13,10 @@ namespace flutter_webrtc_plugin {
 class FlutterWebRTCPluginImpl : public FlutterWebRTCPlugin {
  public:
   static void RegisterWithRegistrar(PluginRegistrar* registrar) {
+    // Registration runs on the platform thread; bind the task runner here
+    // before any libwebrtc thread can post to it.
+    TaskRunner::InitializePlatform();
+
     auto channel = std::make_unique<MethodChannel>(
         registrar->messenger(), kChannelName,
         &flutter::StandardMethodCodec::GetInstance());
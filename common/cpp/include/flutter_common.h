@@ -10,9 +10,14 @@
 #include <flutter/standard_method_codec.h>
 #include <flutter/texture_registrar.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 
 typedef flutter::EncodableValue EncodableValue;
 typedef flutter::EncodableMap EncodableMap;
@@ -30,15 +35,21 @@ typedef flutter::MethodResult<EncodableValue> MethodResult;
 // foo.IsString() becomes std::holds_alternative<std::string>(foo)
 
 template <typename T>
-inline bool TypeIs(const EncodableValue val) {
+inline bool TypeIs(const EncodableValue& val) {
   return std::holds_alternative<T>(val);
 }
 
 template <typename T>
-inline const T GetValue(EncodableValue val) {
+inline const T& GetValue(const EncodableValue& val) {
   return std::get<T>(val);
 }
 
+// Temporaries are moved out instead of handing back a dangling reference.
+template <typename T>
+inline T GetValue(EncodableValue&& val) {
+  return std::get<T>(std::move(val));
+}
+
 inline EncodableValue findEncodableValue(const EncodableMap& map,
                                          const std::string& key) {
   auto it = map.find(EncodableValue(key));
@@ -98,19 +109,143 @@ inline std::vector<uint8_t> findVector(const EncodableMap& map,
 }
 
 inline int64_t findLongInt(const EncodableMap& map, const std::string& key) {
-  for (auto it : map) {
-    if (key == GetValue<std::string>(it.first)) {
-      if (TypeIs<int64_t>(it.second)) {
-        return GetValue<int64_t>(it.second);
-      } else if (TypeIs<int32_t>(it.second)) {
-        return GetValue<int32_t>(it.second);
-      }
+  auto it = map.find(EncodableValue(key));
+  if (it != map.end()) {
+    if (TypeIs<int64_t>(it->second)) {
+      return GetValue<int64_t>(it->second);
+    } else if (TypeIs<int32_t>(it->second)) {
+      return GetValue<int32_t>(it->second);
     }
   }
-
   return -1;
 }
 
+// Reference accessors. These return pointers into |map| instead of copies,
+// or nullptr if |key| is missing or holds a different type. The pointers
+// are only valid as long as |map| is.
+//
+// Lookups allocate nothing: map.find() would need |key| copied into an
+// EncodableValue first. String keys sort together and in string order, so
+// the scan stops at the first one past |key|; argument maps are small.
+inline const EncodableValue* findValueRef(const EncodableMap& map,
+                                          std::string_view key) {
+  for (const auto& entry : map) {
+    const std::string* name = std::get_if<std::string>(&entry.first);
+    if (name == nullptr)
+      continue;
+    int order = std::string_view(*name).compare(key);
+    if (order == 0)
+      return &entry.second;
+    if (order > 0)
+      break;
+  }
+  return nullptr;
+}
+
+inline const EncodableMap* findMapRef(const EncodableMap& map,
+                                      std::string_view key) {
+  const EncodableValue* value = findValueRef(map, key);
+  return value ? std::get_if<EncodableMap>(value) : nullptr;
+}
+
+inline const EncodableList* findListRef(const EncodableMap& map,
+                                        std::string_view key) {
+  const EncodableValue* value = findValueRef(map, key);
+  return value ? std::get_if<EncodableList>(value) : nullptr;
+}
+
+inline const std::string* findStringRef(const EncodableMap& map,
+                                        std::string_view key) {
+  const EncodableValue* value = findValueRef(map, key);
+  return value ? std::get_if<std::string>(value) : nullptr;
+}
+
+inline const std::vector<uint8_t>* findVectorRef(const EncodableMap& map,
+                                                 std::string_view key) {
+  const EncodableValue* value = findValueRef(map, key);
+  return value ? std::get_if<std::vector<uint8_t>>(value) : nullptr;
+}
+
+// Non-owning, typed view of a method call argument map. Missing keys and
+// type mismatches resolve to the same defaults as the find* helpers above,
+// but containers and strings are returned by reference, so reading nested
+// arguments never copies the tree. The view must not outlive the
+// EncodableValue it was created from.
+class ArgView {
+ public:
+  ArgView() = default;
+  explicit ArgView(const EncodableMap* map) : map_(map) {}
+  explicit ArgView(const EncodableValue* value)
+      : map_(value ? std::get_if<EncodableMap>(value) : nullptr) {}
+
+  bool empty() const { return map_ == nullptr || map_->empty(); }
+
+  const EncodableMap& map() const { return map_ ? *map_ : EmptyMap(); }
+
+  const EncodableValue& Value(std::string_view key) const {
+    const EncodableValue* value = map_ ? findValueRef(*map_, key) : nullptr;
+    return value ? *value : NullValue();
+  }
+
+  ArgView Map(std::string_view key) const {
+    return ArgView(map_ ? findMapRef(*map_, key) : nullptr);
+  }
+
+  const EncodableList& List(std::string_view key) const {
+    const EncodableList* list = map_ ? findListRef(*map_, key) : nullptr;
+    return list ? *list : EmptyList();
+  }
+
+  const std::string& String(std::string_view key) const {
+    const std::string* str = map_ ? findStringRef(*map_, key) : nullptr;
+    return str ? *str : EmptyString();
+  }
+
+  int Int(std::string_view key) const {
+    const EncodableValue& value = Value(key);
+    return TypeIs<int>(value) ? GetValue<int>(value) : -1;
+  }
+
+  int64_t LongInt(std::string_view key) const {
+    const EncodableValue& value = Value(key);
+    if (TypeIs<int64_t>(value))
+      return GetValue<int64_t>(value);
+    if (TypeIs<int32_t>(value))
+      return GetValue<int32_t>(value);
+    return -1;
+  }
+
+  bool Boolean(std::string_view key) const {
+    const EncodableValue& value = Value(key);
+    return TypeIs<bool>(value) ? GetValue<bool>(value) : false;
+  }
+
+  double Double(std::string_view key) const {
+    const EncodableValue& value = Value(key);
+    return TypeIs<double>(value) ? GetValue<double>(value) : 0.0;
+  }
+
+ private:
+  static const EncodableMap& EmptyMap() {
+    static const EncodableMap empty;
+    return empty;
+  }
+  static const EncodableList& EmptyList() {
+    static const EncodableList empty;
+    return empty;
+  }
+  static const std::string& EmptyString() {
+    static const std::string empty;
+    return empty;
+  }
+  static const EncodableValue& NullValue() {
+    static const EncodableValue null_value;
+    return null_value;
+  }
+
+  const EncodableMap* map_ = nullptr;
+};
+
 inline int toInt(flutter::EncodableValue inputVal, int defaultVal) {
   int intValue = defaultVal;
   if (TypeIs<int>(inputVal)) {
@@ -123,6 +258,30 @@ inline int toInt(flutter::EncodableValue inputVal, int defaultVal) {
   return intValue;
 }
 
+// Helpers for static method tables: arrays of entries with a |name| member,
+// sorted by name so they can be checked at compile time and searched in
+// O(log n) without building a map at startup.
+template <typename Entry, size_t N>
+constexpr bool IsSortedByName(const Entry (&entries)[N]) {
+  for (size_t i = 1; i < N; i++) {
+    if (!(entries[i - 1].name < entries[i].name))
+      return false;
+  }
+  return true;
+}
+
+template <typename Entry, size_t N>
+inline const Entry* FindByName(const Entry (&entries)[N],
+                               std::string_view name) {
+  auto it = std::lower_bound(entries, entries + N, name,
+                             [](const Entry& entry, std::string_view key) {
+                               return entry.name < key;
+                             });
+  if (it != entries + N && it->name == name)
+    return it;
+  return nullptr;
+}
+
 class MethodCallProxy {
  public:
   static std::unique_ptr<MethodCallProxy> Create(const MethodCall& call);
@@ -159,16 +318,107 @@ class MethodResultProxy {
   virtual void NotImplemented() = 0;
 };
 
+// Runs closures on the platform thread, the only thread that may talk to the
+// engine. libwebrtc callbacks arrive on its own signaling/worker threads and
+// hop over through this.
+class TaskRunner {
+ public:
+  // Binds the platform runner to the calling thread. Plugin registration
+  // calls this on the platform thread before any libwebrtc thread can post.
+  static void InitializePlatform();
+
+  // The runner bound to the platform thread. InitializePlatform() must have
+  // been called.
+  static TaskRunner* Platform();
+
+  virtual ~TaskRunner() = default;
+
+  // Safe to call from any thread; |task| runs later on the runner's thread.
+  virtual void EnqueueTask(std::function<void()> task) = 0;
+
+  // Like EnqueueTask, but runs |task| no sooner than |delay| from now.
+  virtual void EnqueueDelayedTask(std::function<void()> task,
+                                  std::chrono::milliseconds delay) = 0;
+};
+
+// Lock-free histogram of durations for percentile reporting. Buckets are
+// log-linear (four per power of two of microseconds), so percentiles are
+// reported within 25% of the true value at any scale.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  // Safe to call from any thread.
+  void Record(std::chrono::microseconds value);
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  // Upper bound of the bucket holding the |percentile| (0-100) sample, or
+  // zero when nothing was recorded.
+  int64_t PercentileMicros(double percentile) const;
+
+ private:
+  static constexpr int kSubBuckets = 4;
+  static constexpr int kBuckets = kSubBuckets * 40;
+
+  static int BucketFor(uint64_t micros);
+  static int64_t BucketUpperBound(int bucket);
+
+  std::atomic<uint64_t> buckets_[kBuckets];
+  std::atomic<uint64_t> count_{0};
+};
+
+// How an EventChannelProxy buffers events that are sent before the Dart side
+// starts listening.
+struct EventQueueOptions {
+  enum class OverflowPolicy {
+    // Evict the oldest queued event to make room for the new one.
+    kDropOldest,
+    // Keep the queue as it is and discard the new event.
+    kDropNewest,
+  };
+
+  size_t capacity = 256;
+  OverflowPolicy overflow_policy = OverflowPolicy::kDropOldest;
+
+  // When set, events are sent as one EncodableList per batch instead of one
+  // platform message each. A batch is flushed once it holds
+  // |max_batch_size| events or |batch_window| after its first event,
+  // whichever comes first; a batch of one is sent as the bare event. The
+  // Dart listener must accept both shapes.
+  bool batch_events = false;
+  std::chrono::milliseconds batch_window{5};
+  size_t max_batch_size = 64;
+
+  // Defaults with batching turned on, for high-frequency channels.
+  static EventQueueOptions Batched() {
+    EventQueueOptions options;
+    options.batch_events = true;
+    return options;
+  }
+};
+
 class EventChannelProxy {
  public:
   static std::unique_ptr<EventChannelProxy> Create(
       BinaryMessenger* messenger,
-      const std::string& channelName);
+      const std::string& channelName,
+      const EventQueueOptions& options = EventQueueOptions());
 
   virtual ~EventChannelProxy() = default;
 
+  // Safe to call from any thread. Events are queued and delivered, in order,
+  // by a drain task on the platform thread.
   virtual void Success(const EncodableValue& event,
                        bool cache_event = true) = 0;
+
+  // Number of queued events discarded because the queue was full.
+  virtual uint64_t dropped_events() const = 0;
+
+  // Number of queued state events (signalingState, iceConnectionState,
+  // didTextureChangeVideoSize, ...) replaced by a newer event of the same
+  // kind before they were delivered.
+  virtual uint64_t coalesced_events() const = 0;
 };
 
 #endif  // FLUTTER_WEBRTC_COMMON_HXX
@@ -0,0 +1,143 @@
+#ifndef FLUTTER_WEBRTC_RTC_COMPOSITE_RENDERER_HXX
+#define FLUTTER_WEBRTC_RTC_COMPOSITE_RENDERER_HXX
+
+#include "flutter_video_renderer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+// Draws several video tracks into one RGBA texture, e.g. for a conference
+// grid. Each track gets a region of the canvas; a region is scaled and
+// converted straight from I420 into place, and only when its track has
+// delivered a new frame. Frames reach the compositor through the same
+// per-track hubs as plain renderers, so a track shown both here and in its
+// own texture is still subscribed only once.
+class FlutterCompositeRenderer : public RefCountInterface {
+ public:
+  struct Region {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+  };
+
+  // Compositions per second unless SetMaxFps says otherwise.
+  static constexpr int kDefaultMaxFps = 30;
+
+  FlutterCompositeRenderer() = default;
+  ~FlutterCompositeRenderer();
+
+  void initialize(TextureRegistrar* registrar,
+                  std::unique_ptr<flutter::TextureVariant> texture,
+                  int64_t texture_id,
+                  FlutterVideoRendererManager* manager,
+                  std::shared_ptr<PixelBufferPool> buffer_pool);
+
+  virtual const FlutterDesktopPixelBuffer* CopyPixelBuffer(size_t width,
+                                                           size_t height) const;
+
+  // Shows |tracks[i]| in |regions[i]| of a |width| x |height| canvas. Null
+  // tracks, and tracks without a region, are not drawn. Regions are clipped
+  // to the canvas. Platform thread only.
+  void SetLayout(size_t width,
+                 size_t height,
+                 std::vector<scoped_refptr<RTCVideoTrack>> tracks,
+                 std::vector<Region> regions);
+
+  // Composes the canvas at most |max_fps| times per second; frames arriving
+  // in between only update their regions' pending frames. Ignored unless
+  // positive.
+  void SetMaxFps(int max_fps);
+
+  // Detaches from every track. Platform thread only.
+  void Clear();
+
+  size_t width() const { return width_; }
+  size_t height() const { return height_; }
+  const std::vector<scoped_refptr<RTCVideoTrack>>& tracks() const {
+    return tracks_;
+  }
+
+  // Splits a |width| x |height| canvas into the smallest near-square grid
+  // holding |count| cells, filled row by row.
+  static std::vector<Region> GridLayout(size_t count,
+                                        size_t width,
+                                        size_t height);
+
+ private:
+  // Hub sink for one region; tags frames with the region they belong to.
+  class RegionSink : public VideoFrameSink {
+   public:
+    RegionSink(FlutterCompositeRenderer* owner, size_t index)
+        : owner_(owner), index_(index) {}
+
+    virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override {
+      owner_->OnRegionFrame(index_, frame);
+    }
+
+   private:
+    FlutterCompositeRenderer* owner_;
+    size_t index_;
+  };
+
+  void OnRegionFrame(size_t index, scoped_refptr<RTCVideoFrame> frame);
+
+  void ComposeFrames();
+
+  // Letterboxes |frame| into |region| of |canvas_|, scaled to fit.
+  void DrawRegion(const Region& region,
+                  const scoped_refptr<RTCVideoFrame>& frame);
+
+  void StopComposeThread();
+
+  TextureRegistrar* registrar_ = nullptr;
+  FlutterVideoRendererManager* manager_ = nullptr;
+  std::unique_ptr<flutter::TextureVariant> texture_;
+  int64_t texture_id_ = -1;
+  std::shared_ptr<PixelBufferPool> buffer_pool_;
+
+  // Platform thread only.
+  size_t width_ = 0;
+  size_t height_ = 0;
+  std::vector<scoped_refptr<RTCVideoTrack>> tracks_;
+  std::vector<std::unique_ptr<RegionSink>> sinks_;
+
+  // Layout and newest frame per region, shared with the compose thread.
+  // |dirty_| marks regions whose frame has not been drawn yet.
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  size_t canvas_width_ = 0;
+  size_t canvas_height_ = 0;
+  std::vector<Region> regions_;
+  std::vector<scoped_refptr<RTCVideoFrame>> frames_;
+  std::vector<bool> dirty_;
+  // Set when the layout changed and the whole canvas must be redrawn.
+  bool relayout_ = false;
+  bool stop_compose_ = false;
+  std::thread compose_thread_;
+  std::atomic<int64_t> compose_interval_us_{1000000 / kDefaultMaxFps};
+
+  // Compose thread only. The canvas persists between frames so regions
+  // without a new frame keep their last picture.
+  std::vector<uint8_t> canvas_;
+  size_t drawn_width_ = 0;
+  size_t drawn_height_ = 0;
+  std::chrono::steady_clock::time_point next_compose_;
+  I420ScaleScratch scale_scratch_;
+  std::vector<uint8_t> rotate_scratch_;
+
+  mutable std::mutex buffer_mutex_;
+  mutable std::shared_ptr<const ConvertedVideoFrame> front_;
+  mutable std::shared_ptr<const ConvertedVideoFrame> ready_;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_RTC_COMPOSITE_RENDERER_HXX
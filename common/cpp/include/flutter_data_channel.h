@@ -10,7 +10,9 @@ class FlutterRTCDataChannelObserver : public RTCDataChannelObserver {
  public:
   FlutterRTCDataChannelObserver(scoped_refptr<RTCDataChannel> data_channel,
                                 BinaryMessenger* messenger,
-                                const std::string& channel_name);
+                                const std::string& channel_name,
+                                const EventQueueOptions& event_options =
+                                    EventQueueOptions());
   virtual ~FlutterRTCDataChannelObserver();
 
   virtual void OnStateChange(RTCDataChannelState state) override;
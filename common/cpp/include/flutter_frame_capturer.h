@@ -2,36 +2,75 @@
 #define FLUTTER_WEBRTC_RTC_FRAME_CAPTURER_HXX
 
 #include "flutter_common.h"
+#include "flutter_image_encoder.h"
 #include "flutter_webrtc_base.h"
 
 #include "rtc_video_frame.h"
 #include "rtc_video_renderer.h"
 
-#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
 
 namespace flutter_webrtc_plugin {
 
 using namespace libwebrtc;
 
+struct FrameCaptureOptions {
+  // Where to save the image. When empty the image is returned in the method
+  // result instead, as {data, width, height, format}.
+  std::string path;
+  ImageEncodeOptions encode;
+  // Skip encoding and produce the converted RGBA pixels as they are.
+  bool raw_rgba = false;
+  // How long to wait for the track to deliver a frame.
+  std::chrono::milliseconds timeout{5000};
+};
+
+// Grabs the next frame of a video track and saves it as an image, or hands
+// the image back in the method result. Captures are asynchronous: the
+// platform thread only registers the capturer, the frame is encoded on the
+// shared worker pool, and the result is completed back on the platform
+// thread. Any number of captures may run at once.
 class FlutterFrameCapturer
-    : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>> {
+    : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>>,
+      public std::enable_shared_from_this<FlutterFrameCapturer> {
  public:
-  FlutterFrameCapturer(RTCVideoTrack* track, std::string path);
+  // Platform thread only. |result| is completed once the frame is saved,
+  // or with an error when no frame arrives within |options.timeout|.
+  static void Capture(scoped_refptr<RTCVideoTrack> track,
+                      const FrameCaptureOptions& options,
+                      std::unique_ptr<MethodResultProxy> result);
 
-  virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+  FlutterFrameCapturer(scoped_refptr<RTCVideoTrack> track,
+                       const FrameCaptureOptions& options,
+                       std::unique_ptr<MethodResultProxy> result);
 
-  void CaptureFrame(std::unique_ptr<MethodResultProxy> result);
+  virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
 
  private:
-  RTCVideoTrack* track_;
-  std::string path_;
-  std::mutex mutex_;
-  scoped_refptr<RTCVideoFrame> frame_;
-  volatile bool catch_frame_;
+  void Start();
+
+  // Platform thread. Unregisters from the track and completes the result
+  // with |value|, or with |error| when |ok| is false.
+  void Finish(bool ok, const EncodableValue& value, const std::string& error);
+
+  void OnTimeout();
+
+  // Worker thread. Converts and encodes |frame|, then either saves it to
+  // options_.path or stores the result map in |value|.
+  bool ProcessFrame(const scoped_refptr<RTCVideoFrame>& frame,
+                    EncodableValue* value);
 
-  bool SaveFrame();
+  scoped_refptr<RTCVideoTrack> track_;
+  FrameCaptureOptions options_;
+  std::unique_ptr<MethodResultProxy> result_;
+  // Set by whichever of the first frame and the timeout comes first.
+  std::atomic<bool> claimed_{false};
+  // Reference held on our own behalf while registered with the track.
+  std::shared_ptr<FlutterFrameCapturer> self_;
 };
 
 }  // namespace flutter_webrtc_plugin
 
-#endif  // !FLUTTER_WEBRTC_RTC_FRAME_CAPTURER_HXX
\ No newline at end of file
+#endif  // !FLUTTER_WEBRTC_RTC_FRAME_CAPTURER_HXX
@@ -23,9 +23,13 @@ class FlutterFrameCryptor {
  public:
   FlutterFrameCryptor(FlutterWebRTCBase* base) : base_(base) {}
 
+  // Dispatches a frame cryptor method. Returns false and hands |result| back
+  // through |outResult| if |method_name| is not a frame cryptor method.
   bool HandleFrameCryptorMethodCall(
-    const MethodCallProxy& method_call,
-    std::unique_ptr<MethodResultProxy> result);
+      const std::string& method_name,
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result,
+      std::unique_ptr<MethodResultProxy>* outResult);
 
   void FrameCryptorFactoryCreateFrameCryptor(
       const EncodableMap& constraints,
@@ -0,0 +1,42 @@
+#ifndef FLUTTER_WEBRTC_IMAGE_ENCODER_HXX
+#define FLUTTER_WEBRTC_IMAGE_ENCODER_HXX
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+enum class ImageFormat {
+  kPng,
+  kJpeg,
+};
+
+struct ImageEncodeOptions {
+  ImageFormat format = ImageFormat::kPng;
+  // JPEG quality, 1 (smallest) to 100 (best). Ignored for PNG.
+  int quality = 90;
+};
+
+// Maps "png", "jpeg" or "jpg" to a format. Returns false for anything else.
+bool ImageFormatFromName(const std::string& name, ImageFormat* format);
+
+// Encodes an RGBA image with |stride| bytes per row into |out|, replacing its
+// contents but keeping its capacity, so a reused vector stops allocating
+// once it has grown to the working size. Alpha is ignored: video frames are
+// always opaque, so images are written as RGB.
+//
+// PNG rows are filtered and deflated in bands on the shared worker pool;
+// each band ends on a byte boundary so the bands concatenate into a single
+// zlib stream. JPEG is baseline with 4:2:0 chroma.
+bool EncodeImage(const uint8_t* rgba,
+                 int width,
+                 int height,
+                 int stride,
+                 const ImageEncodeOptions& options,
+                 std::vector<uint8_t>* out);
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_IMAGE_ENCODER_HXX
@@ -0,0 +1,81 @@
+#ifndef FLUTTER_WEBRTC_LATEST_VALUE_SLOT_HXX
+#define FLUTTER_WEBRTC_LATEST_VALUE_SLOT_HXX
+
+#include <atomic>
+#include <utility>
+
+namespace flutter_webrtc_plugin {
+
+// Single-slot mailbox for the newest value handed from a producer thread to
+// a consumer thread, e.g. a frame together with its metadata; the consumer
+// always takes the fields of one Put together. Neither side ever waits for
+// the other, and a value replaced before it was taken is dropped. Values
+// travel in heap nodes that are recycled through two spares. At most three
+// nodes are in use at once (the slot's and one in each thread's hands), so
+// a steady producer and consumer stop allocating whatever their rates.
+template <typename T>
+class LatestValueSlot {
+ public:
+  LatestValueSlot() = default;
+  ~LatestValueSlot() {
+    delete slot_.exchange(nullptr);
+    for (std::atomic<T*>& spare : spares_)
+      delete spare.exchange(nullptr);
+  }
+
+  LatestValueSlot(const LatestValueSlot&) = delete;
+  LatestValueSlot& operator=(const LatestValueSlot&) = delete;
+
+  // Returns false when an untaken value was replaced.
+  bool Put(T value) {
+    T* node = TakeSpare();
+    if (node)
+      *node = std::move(value);
+    else
+      node = new T(std::move(value));
+    T* previous = slot_.exchange(node);
+    if (!previous)
+      return true;
+    Recycle(previous);
+    return false;
+  }
+
+  // Moves the newest value into |value|; returns false if there is none.
+  bool Take(T* value) {
+    T* node = slot_.exchange(nullptr);
+    if (!node)
+      return false;
+    *value = std::move(*node);
+    Recycle(node);
+    return true;
+  }
+
+  bool empty() const { return slot_.load() == nullptr; }
+
+ private:
+  T* TakeSpare() {
+    for (std::atomic<T*>& spare : spares_) {
+      if (T* node = spare.exchange(nullptr))
+        return node;
+    }
+    return nullptr;
+  }
+
+  void Recycle(T* node) {
+    // Release what the value holds now, not when the node is reused.
+    *node = T();
+    for (std::atomic<T*>& spare : spares_) {
+      node = spare.exchange(node);
+      if (!node)
+        return;
+    }
+    delete node;
+  }
+
+  std::atomic<T*> slot_{nullptr};
+  std::atomic<T*> spares_[2] = {};
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // FLUTTER_WEBRTC_LATEST_VALUE_SLOT_HXX
@@ -0,0 +1,113 @@
+#ifndef FLUTTER_WEBRTC_RTC_MEDIA_RECORDER_HXX
+#define FLUTTER_WEBRTC_RTC_MEDIA_RECORDER_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+#include "flutter_yuv_converter.h"
+
+#include "rtc_video_frame.h"
+#include "rtc_video_renderer.h"
+#include "rtc_video_track.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+using namespace libwebrtc;
+
+// Records a video track to a Y4M file (raw I420). Frames are copied off
+// libwebrtc's decode thread into a bounded queue, and a dedicated writer
+// thread streams them to disk. When the disk falls behind, new frames are
+// dropped and counted rather than blocking the decoder. Frames at another
+// size than the first are scaled to it, since the file has one size.
+class FlutterMediaRecorder
+    : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>>,
+      public std::enable_shared_from_this<FlutterMediaRecorder> {
+ public:
+  // Bytes of copied frames allowed to wait for the writer; about a second
+  // of 1080p at 30 fps.
+  static constexpr size_t kDefaultMaxQueuedBytes = 96 * 1024 * 1024;
+
+  FlutterMediaRecorder(scoped_refptr<RTCVideoTrack> track,
+                       const std::string& path,
+                       size_t max_queued_bytes = kDefaultMaxQueuedBytes);
+  ~FlutterMediaRecorder();
+
+  // Platform thread. Opens |path_| and starts recording. Returns false with
+  // |error| set if the file cannot be created.
+  bool Start(std::string* error);
+
+  // Platform thread. Stops taking frames, lets the writer drain what is
+  // queued, and completes |result| with the recording's statistics once the
+  // file is closed.
+  void Stop(std::unique_ptr<MethodResultProxy> result);
+
+  virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+
+ private:
+  void WriterLoop();
+
+  // Platform thread, once the writer has finished.
+  void Complete();
+
+  std::vector<uint8_t> TakeBuffer();
+
+  scoped_refptr<RTCVideoTrack> track_;
+  const std::string path_;
+  const size_t max_queued_bytes_;
+  FILE* file_ = nullptr;
+  std::thread writer_;
+  std::unique_ptr<MethodResultProxy> stop_result_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Packed frames ("FRAME\n" plus the three planes) waiting to be written.
+  std::deque<std::vector<uint8_t>> queue_;
+  // Written buffers kept for reuse by OnFrame.
+  std::vector<std::vector<uint8_t>> free_buffers_;
+  size_t queued_bytes_ = 0;
+  bool stopping_ = false;
+
+  // Set from the first frame; Y4M cannot change size mid-stream.
+  int width_ = 0;
+  int height_ = 0;
+  // Decode thread only.
+  I420ScaleScratch scale_scratch_;
+
+  std::atomic<bool> write_failed_{false};
+  std::atomic<uint64_t> frames_written_{0};
+  std::atomic<uint64_t> frames_dropped_{0};
+  std::atomic<uint64_t> frames_resized_{0};
+  std::atomic<uint64_t> bytes_written_{0};
+};
+
+class FlutterMediaRecorderManager {
+ public:
+  FlutterMediaRecorderManager(FlutterWebRTCBase* base);
+  ~FlutterMediaRecorderManager();
+
+  void StartRecordToFile(const std::string& path,
+                         int64_t recorder_id,
+                         RTCVideoTrack* track,
+                         std::unique_ptr<MethodResultProxy> result);
+
+  void StopRecordToFile(int64_t recorder_id,
+                        std::unique_ptr<MethodResultProxy> result);
+
+ private:
+  FlutterWebRTCBase* base_;
+  std::map<int64_t, std::shared_ptr<FlutterMediaRecorder>> recorders_;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_RTC_MEDIA_RECORDER_HXX
@@ -0,0 +1,58 @@
+#ifndef FLUTTER_WEBRTC_METHOD_BATCH_HXX
+#define FLUTTER_WEBRTC_METHOD_BATCH_HXX
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "flutter_common.h"
+
+namespace flutter_webrtc_plugin {
+
+// Runs the operations of an executeBatch call one after another and replies
+// once with the list of per-operation outcomes. Handlers may complete
+// asynchronously (createOffer, setRemoteDescription, ...), so the next
+// operation is only started when the previous one has replied, either
+// inline or later from a libwebrtc callback.
+class MethodBatch : public std::enable_shared_from_this<MethodBatch> {
+ public:
+  typedef std::function<void(const std::string& method_name,
+                             const EncodableValue* arguments,
+                             std::unique_ptr<MethodResultProxy> result)>
+      Dispatcher;
+
+  MethodBatch(EncodableList operations,
+              bool stop_on_error,
+              Dispatcher dispatcher,
+              std::unique_ptr<MethodResultProxy> result)
+      : operations_(std::move(operations)),
+        stop_on_error_(stop_on_error),
+        dispatcher_(std::move(dispatcher)),
+        result_(std::move(result)) {
+    results_.reserve(operations_.size());
+  }
+
+  // Starts, or after an asynchronous reply resumes, the batch. Must be
+  // called on the platform thread, on a batch owned by a shared_ptr.
+  void Run();
+
+  // Records the outcome of the current operation; called by its result.
+  void OnOperationComplete(EncodableMap outcome, bool failed);
+
+ private:
+  EncodableList operations_;
+  bool stop_on_error_;
+  Dispatcher dispatcher_;
+  std::unique_ptr<MethodResultProxy> result_;
+  EncodableList results_;
+  size_t next_ = 0;
+  bool stopped_ = false;
+  bool current_completed_ = false;
+  bool waiting_for_async_ = false;
+  std::mutex mutex_;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // FLUTTER_WEBRTC_METHOD_BATCH_HXX
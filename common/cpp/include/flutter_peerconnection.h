@@ -2,6 +2,7 @@
 #define FLUTTER_WEBRTC_RTC_PEER_CONNECTION_HXX
 
 #include "flutter_common.h"
+#include "flutter_frame_capturer.h"
 #include "flutter_webrtc_base.h"
 
 namespace flutter_webrtc_plugin {
@@ -12,7 +13,12 @@ class FlutterPeerConnectionObserver : public RTCPeerConnectionObserver {
                                 scoped_refptr<RTCPeerConnection> peerconnection,
                                 BinaryMessenger* messenger,
                                 const std::string& channel_name,
-                                std::string& peerConnectionId);
+                                std::string& peerConnectionId,
+                                std::chrono::milliseconds
+                                    candidate_batch_window =
+                                        std::chrono::milliseconds(0),
+                                const EventQueueOptions& event_options =
+                                    EventQueueOptions());
 
   virtual void OnSignalingState(RTCSignalingState state) override;
   virtual void OnPeerConnectionState(RTCPeerConnectionState state) override;
@@ -37,12 +43,29 @@ class FlutterPeerConnectionObserver : public RTCPeerConnectionObserver {
 
   void RemoveStreamForId(const std::string& id);
 
+  // Queue options for this connection's event channel, which its data
+  // channels' event channels share.
+  const EventQueueOptions& event_options() const { return event_options_; }
+
  private:
+  // Sends the candidates held back so far as one "onCandidates" event.
+  void FlushCandidates();
+
+  const EventQueueOptions event_options_;
   std::unique_ptr<EventChannelProxy> event_channel_;
   scoped_refptr<RTCPeerConnection> peerconnection_;
   std::map<std::string, scoped_refptr<RTCMediaStream>> remote_streams_;
   FlutterWebRTCBase* base_;
   std::string id_;
+
+  // When non-zero, local candidates are held back for up to this long, or
+  // until gathering completes, and sent together instead of one
+  // "onCandidate" event each.
+  const std::chrono::milliseconds candidate_batch_window_;
+  std::mutex candidates_mutex_;
+  EncodableList pending_candidates_;
+  // Lets a scheduled flush tell whether the observer is still alive.
+  std::shared_ptr<int> alive_ = std::make_shared<int>(0);
 };
 
 class FlutterPeerConnection {
@@ -120,7 +143,7 @@ class FlutterPeerConnection {
                              std::unique_ptr<MethodResultProxy> result);
 
   scoped_refptr<RTCRtpParameters> updateRtpParameters(
-      EncodableMap newParameters,
+      const EncodableMap& newParameters,
       scoped_refptr<RTCRtpParameters> parameters);
 
   void RtpSenderSetParameters(RTCPeerConnection* pc,
@@ -142,7 +165,7 @@ class FlutterPeerConnection {
                         std::unique_ptr<MethodResultProxy> result);
 
   void CaptureFrame(RTCVideoTrack* track,
-                    std::string path,
+                    const FrameCaptureOptions& options,
                     std::unique_ptr<MethodResultProxy> result);
 
   scoped_refptr<RTCRtpTransceiver> getRtpTransceiverById(RTCPeerConnection* pc,
@@ -166,6 +189,14 @@ class FlutterPeerConnection {
                        RTCPeerConnection* pc,
                        std::unique_ptr<MethodResultProxy> result);
 
+  // Applies every {candidate, sdpMid, sdpMLineIndex} in |candidates| and
+  // answers with one {success, error} entry per candidate, in order.
+  // |success| means the candidate parsed and was submitted: AddCandidate
+  // reports nothing back, so one the connection rejects still succeeds.
+  void AddIceCandidates(const EncodableList& candidates,
+                        RTCPeerConnection* pc,
+                        std::unique_ptr<MethodResultProxy> result);
+
   void GetStats(const std::string& track_id,
                 RTCPeerConnection* pc,
                 std::unique_ptr<MethodResultProxy> result);
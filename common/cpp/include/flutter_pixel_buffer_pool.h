@@ -0,0 +1,93 @@
+#ifndef FLUTTER_WEBRTC_PIXEL_BUFFER_POOL_HXX
+#define FLUTTER_WEBRTC_PIXEL_BUFFER_POOL_HXX
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+// Size-class pool of RGBA pixel buffers shared by all video renderers.
+// Requests are rounded up to a size class (powers of two and the midpoints
+// between them) so a resolution change usually lands on an idle buffer
+// instead of a fresh allocation. Idle bytes are capped at a high-water mark;
+// buffers returned beyond it are freed.
+class PixelBufferPool : public std::enable_shared_from_this<PixelBufferPool> {
+ public:
+  // Owning handle to a pooled buffer; returns it to the pool on destruction.
+  class Buffer {
+   public:
+    Buffer() = default;
+    ~Buffer() { Release(); }
+    Buffer(Buffer&& other) = default;
+    Buffer& operator=(Buffer&& other) {
+      if (this != &other) {
+        Release();
+        pool_ = std::move(other.pool_);
+        data_ = std::move(other.data_);
+        size_ = other.size_;
+        other.size_ = 0;
+      }
+      return *this;
+    }
+
+    uint8_t* data() const { return data_.get(); }
+    // Usable size in bytes; at least what was requested.
+    size_t size() const { return size_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+   private:
+    friend class PixelBufferPool;
+    Buffer(std::shared_ptr<PixelBufferPool> pool,
+           std::unique_ptr<uint8_t[]> data,
+           size_t size)
+        : pool_(std::move(pool)), data_(std::move(data)), size_(size) {}
+
+    void Release();
+
+    std::shared_ptr<PixelBufferPool> pool_;
+    std::unique_ptr<uint8_t[]> data_;
+    size_t size_ = 0;
+  };
+
+  struct Stats {
+    size_t bytes_in_use = 0;
+    size_t bytes_idle = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+
+  static constexpr size_t kDefaultHighWaterBytes = 128 * 1024 * 1024;
+
+  static std::shared_ptr<PixelBufferPool> Create(
+      size_t high_water_bytes = kDefaultHighWaterBytes);
+
+  // Thread-safe.
+  Buffer Acquire(size_t size);
+
+  // Frees idle buffers, largest first, until at most |max_idle_bytes| remain.
+  void Trim(size_t max_idle_bytes);
+
+  Stats stats() const;
+
+ private:
+  explicit PixelBufferPool(size_t high_water_bytes)
+      : high_water_bytes_(high_water_bytes) {}
+
+  static size_t SizeClass(size_t size);
+
+  void Return(std::unique_ptr<uint8_t[]> data, size_t size);
+
+  const size_t high_water_bytes_;
+  mutable std::mutex mutex_;
+  std::map<size_t, std::vector<std::unique_ptr<uint8_t[]>>> idle_;
+  Stats stats_;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_PIXEL_BUFFER_POOL_HXX
@@ -0,0 +1,133 @@
+#ifndef FLUTTER_WEBRTC_RTC_SNAPSHOT_SAMPLER_HXX
+#define FLUTTER_WEBRTC_RTC_SNAPSHOT_SAMPLER_HXX
+
+#include "flutter_image_encoder.h"
+#include "flutter_video_renderer.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+// Takes a thumbnail of every subscribed video track once per interval, e.g.
+// for moderation. Each track gets one sink on its shared frame hub that
+// only forwards the first frame after a sample is due, so idle tracks cost
+// an atomic load per frame. Thumbnails are downscaled and encoded on the shared
+// worker pool with a fixed number of encodes in flight, so encode CPU does
+// not grow with the number of tracks: when the pool falls behind, a track's
+// older sample is replaced by its newer one and counted as skipped.
+//
+// Each round of samples is delivered as one "didCaptureSnapshots" event,
+// carrying the encoded bytes or, with a directory set, the path of the file
+// written into a per-track ring of |ring_size| files. The event is sent as
+// soon as every track has been sampled, or at the next round for tracks
+// that delivered no frame.
+class FlutterSnapshotSampler
+    : public std::enable_shared_from_this<FlutterSnapshotSampler> {
+ public:
+  struct Options {
+    std::chrono::milliseconds interval{5000};
+    // Thumbnails fit within this box, keeping their aspect ratio.
+    int max_width = 320;
+    int max_height = 240;
+    ImageEncodeOptions encode;
+    // Empty to deliver the bytes in the event instead of files.
+    std::string directory;
+    int ring_size = 10;
+    int max_concurrent_encodes = 1;
+  };
+
+  FlutterSnapshotSampler(FlutterVideoRendererManager* manager,
+                         EventChannelProxy* event_channel,
+                         const Options& options);
+  ~FlutterSnapshotSampler();
+
+  // Platform thread only. Starts the sampling timer.
+  void Start();
+
+  // Platform thread only. Samples exactly |tracks|, keyed by track id; null
+  // tracks are ignored. Tracks sampled before keep their ring position.
+  void SetTracks(
+      const std::vector<std::pair<std::string, scoped_refptr<RTCVideoTrack>>>&
+          tracks);
+
+  // Platform thread only. Detaches from every track and stops delivering;
+  // encodes in flight finish and are discarded.
+  void Stop();
+
+ private:
+  class TrackSink : public VideoFrameSink {
+   public:
+    TrackSink(std::weak_ptr<FlutterSnapshotSampler> sampler,
+              uint64_t id,
+              const std::string& track_id,
+              scoped_refptr<RTCVideoTrack> track)
+        : sampler_(sampler), id_(id), track_id_(track_id), track_(track) {}
+
+    // Hands the first frame after arming to the platform thread, so the
+    // sample is fresh and the decoder's buffer is not held for a round.
+    virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+
+    const std::weak_ptr<FlutterSnapshotSampler> sampler_;
+    // Unique per sink, so a frame posted by a sink removed since is dropped.
+    const uint64_t id_;
+    const std::string track_id_;
+    const scoped_refptr<RTCVideoTrack> track_;
+    // Set once per interval; cleared by the frame that is sampled.
+    std::atomic<bool> armed_{false};
+    // Platform thread only.
+    uint64_t samples_ = 0;
+  };
+
+  struct Job {
+    std::string track_id;
+    scoped_refptr<RTCVideoFrame> frame;
+    uint64_t sample_index = 0;
+  };
+
+  // Per-encode working memory, recycled so steady sampling stops
+  // allocating.
+  struct Workspace {
+    I420ScaleScratch scale_scratch;
+    std::vector<uint8_t> pixels;
+    std::vector<uint8_t> rotated;
+    std::vector<uint8_t> encoded;
+  };
+
+  void ScheduleTick();
+  void Tick();
+  void OnSample(uint64_t sink_id, scoped_refptr<RTCVideoFrame> frame);
+  void Dispatch();
+
+  // Worker thread. Returns the snapshot's event entry, or an empty value if
+  // it could not be produced.
+  EncodableValue Process(const Job& job, Workspace* workspace) const;
+
+  void OnProcessed(EncodableValue snapshot,
+                   std::shared_ptr<Workspace> workspace);
+  void FlushBatch();
+
+  FlutterVideoRendererManager* manager_;
+  EventChannelProxy* event_channel_;
+  const Options options_;
+
+  // Platform thread only.
+  std::vector<std::unique_ptr<TrackSink>> sinks_;
+  std::deque<Job> pending_;
+  int in_flight_ = 0;
+  std::vector<std::shared_ptr<Workspace>> idle_workspaces_;
+  EncodableList batch_;
+  // Sinks armed this round that have not delivered a frame yet.
+  size_t awaiting_samples_ = 0;
+  uint64_t next_sink_id_ = 1;
+  uint64_t skipped_ = 0;
+  bool stopped_ = true;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_RTC_SNAPSHOT_SAMPLER_HXX
@@ -2,20 +2,104 @@
 #define FLUTTER_WEBRTC_RTC_VIDEO_RENDERER_HXX
 
 #include "flutter_common.h"
+#include "flutter_latest_value_slot.h"
+#include "flutter_pixel_buffer_pool.h"
 #include "flutter_webrtc_base.h"
+#include "flutter_yuv_converter.h"
 
 #include "rtc_video_frame.h"
 #include "rtc_video_renderer.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <thread>
 
 namespace flutter_webrtc_plugin {
 
 using namespace libwebrtc;
 
-class FlutterVideoRenderer
-    : public RTCVideoRenderer<scoped_refptr<RTCVideoFrame>>,
-      public RefCountInterface {
+class FlutterVideoRendererManager;
+class FlutterCompositeRenderer;
+class FlutterSnapshotSampler;
+
+typedef RTCVideoRenderer<scoped_refptr<RTCVideoFrame>> VideoFrameSink;
+
+// An RGBA frame produced by the conversion thread. Immutable once published,
+// so textures showing the same track at the same size can share one.
+struct ConvertedVideoFrame {
+  PixelBufferPool::Buffer pixels;
+  FlutterDesktopPixelBuffer pixel_buffer = {};
+};
+
+// What a conversion produces, beyond the source frame itself.
+struct VideoConversionKey {
+  size_t width = 0;
+  size_t height = 0;
+  RTCVideoFrame::VideoRotation rotation = RTCVideoFrame::kVideoRotation_0;
+
+  bool operator==(const VideoConversionKey& other) const {
+    return width == other.width && height == other.height &&
+           rotation == other.rotation;
+  }
+};
+
+// Subscribes to a video track once on behalf of every texture showing it,
+// fans frames out to them, and lets textures that want the same output
+// share a single conversion of each frame.
+class FlutterVideoFrameHub : public VideoFrameSink, public RefCountInterface {
+ public:
+  typedef std::function<std::shared_ptr<const ConvertedVideoFrame>()>
+      ConvertFunction;
+
+  virtual void OnFrame(scoped_refptr<RTCVideoFrame> frame) override;
+
+  void Attach(VideoFrameSink* sink);
+
+  // Returns true when no sink is left. Once this returns, |sink| receives no
+  // further frames.
+  bool Detach(VideoFrameSink* sink);
+
+  // Returns the conversion of |frame| described by |key|, running |convert|
+  // only if no other renderer has produced (or is producing) it already.
+  std::shared_ptr<const ConvertedVideoFrame> Convert(
+      const scoped_refptr<RTCVideoFrame>& frame,
+      const VideoConversionKey& key,
+      const ConvertFunction& convert);
+
+ private:
+  struct CachedConversion {
+    scoped_refptr<RTCVideoFrame> source;
+    VideoConversionKey key;
+    std::shared_ptr<const ConvertedVideoFrame> converted;
+  };
+
+  std::mutex sinks_mutex_;
+  std::vector<VideoFrameSink*> sinks_;
+
+  // Conversions of the newest frame only; older entries are dropped as soon
+  // as a newer frame is converted.
+  std::mutex cache_mutex_;
+  std::condition_variable cache_cv_;
+  std::vector<CachedConversion> cache_;
+};
+
+// How a renderer decides which delivered frames are converted and shown.
+enum class FramePacing {
+  // Convert the newest frame whenever the conversion thread is free.
+  kLatestOnly,
+  // As kLatestOnly, but frames arriving faster than a maximum rate are
+  // dropped on arrival.
+  kMaxFps,
+  // Convert at most one frame per engine pull, i.e. per vsync at which the
+  // texture is drawn.
+  kVsync,
+};
+
+class FlutterVideoRenderer : public VideoFrameSink, public RefCountInterface {
  public:
   FlutterVideoRenderer() = default;
   ~FlutterVideoRenderer();
@@ -23,7 +107,9 @@ class FlutterVideoRenderer
   void initialize(TextureRegistrar* registrar,
                   BinaryMessenger* messenger,
                   std::unique_ptr<flutter::TextureVariant> texture,
-                  int64_t texture_id);
+                  int64_t texture_id,
+                  FlutterVideoRendererManager* manager,
+                  std::shared_ptr<PixelBufferPool> buffer_pool);
 
   virtual const FlutterDesktopPixelBuffer* CopyPixelBuffer(size_t width,
                                                            size_t height) const;
@@ -40,28 +126,190 @@ class FlutterVideoRenderer
 
   std::string media_stream_id;
 
+  // When enabled, frames are downscaled to the size the engine last asked
+  // for in CopyPixelBuffer (keeping the source aspect ratio) instead of being
+  // converted at full source resolution.
+  void SetScaleToDisplay(bool enabled) { scale_to_display_ = enabled; }
+
+  // When enabled, the conversion writes upright pixels for rotated frames.
+  // Size events then report the rotated dimensions and the rotation event
+  // always reports 0, so Dart needs no RotatedBox.
+  void SetApplyRotation(bool enabled) { apply_rotation_ = enabled; }
+
+  // Frames with at least this many source pixels are converted in bands on
+  // the shared worker pool. Zero or less keeps every conversion on the
+  // renderer's own thread.
+  static constexpr int64_t kDefaultParallelConversionPixels = 2560 * 1440;
+  void SetParallelConversionThreshold(int64_t pixels) {
+    parallel_threshold_pixels_ = pixels;
+  }
+
+  // |max_fps| is only used by FramePacing::kMaxFps and must be positive
+  // for it.
+  void SetPacing(FramePacing pacing, double max_fps);
+
+  // Frames handed to OnFrame.
+  uint64_t frames_delivered() const {
+    return frames_delivered_.load(std::memory_order_relaxed);
+  }
+
+  // Frames the engine picked up for display.
+  uint64_t frames_rendered() const {
+    return frames_rendered_.load(std::memory_order_relaxed);
+  }
+
+  // Frames superseded before being shown: skipped by pacing, replaced while
+  // waiting for conversion, or converted but replaced before the engine
+  // pulled them.
+  uint64_t frames_dropped() const {
+    return frames_dropped_.load(std::memory_order_relaxed);
+  }
+
+  // Frames converted to RGBA by this renderer's conversion thread.
+  uint64_t conversions_performed() const {
+    return conversions_performed_.load(std::memory_order_relaxed);
+  }
+
+  // Engine copies served from an already converted buffer because no newer
+  // frame had arrived (relayouts, repaints, UI refresh above the video rate).
+  uint64_t conversions_avoided() const {
+    return conversions_avoided_.load(std::memory_order_relaxed);
+  }
+
+  // Counters and latency percentiles, as reported by videoRendererGetStats.
+  EncodableMap Stats() const;
+
+  // When positive, Stats() is also sent as a "didTextureStats" event at most
+  // this often while frames are arriving.
+  void SetStatsInterval(std::chrono::milliseconds interval) {
+    stats_interval_ms_ = interval.count();
+  }
+
+  // Conversions split across the worker pool.
+  uint64_t conversions_parallel() const {
+    return conversions_parallel_.load(std::memory_order_relaxed);
+  }
+
+  // Frames taken from another texture's conversion of the same track.
+  uint64_t conversions_shared() const {
+    return conversions_shared_.load(std::memory_order_relaxed);
+  }
+
  private:
+  // Frames are converted to RGBA on a per-renderer worker thread. The newest
+  // result waits in |ready_| until CopyPixelBuffer promotes it to |front_|,
+  // so the raster thread never converts and never waits on a conversion.
+  // Converted frames are shared and immutable; their pixels go back to the
+  // pool when the last holder lets go.
+  struct PublishedFrame {
+    std::shared_ptr<const ConvertedVideoFrame> frame;
+    // Generation of the source frame, per renderer.
+    uint64_t generation = 0;
+    // When the source frame reached OnFrame, in steady-clock microseconds.
+    int64_t arrival_us = 0;
+  };
   struct FrameSize {
     size_t width;
     size_t height;
   };
+
+  void ConvertFrames();
+
+  std::shared_ptr<const ConvertedVideoFrame> ConvertFrame(
+      const scoped_refptr<RTCVideoFrame>& frame,
+      const VideoConversionKey& key);
+
+  // Output size for a |width| x |height| frame under the current options.
+  FrameSize TargetSize(size_t width, size_t height) const;
+
+  void StopConversionThread();
+
+  void MaybeSendStats();
+
+  // False while vsync pacing waits for the engine to pull the ready frame.
+  bool CanConvert() const;
+
+  // Wakes the conversion thread if it sleeps.
+  void WakeConversionThread() const;
+
   FrameSize last_frame_size_ = {0, 0};
   bool first_frame_rendered = false;
   TextureRegistrar* registrar_ = nullptr;
+  FlutterVideoRendererManager* manager_ = nullptr;
   std::unique_ptr<EventChannelProxy> event_channel_;
   int64_t texture_id_ = -1;
   scoped_refptr<RTCVideoTrack> track_ = nullptr;
-  scoped_refptr<RTCVideoFrame> frame_;
   std::unique_ptr<flutter::TextureVariant> texture_;
-  std::shared_ptr<FlutterDesktopPixelBuffer> pixel_buffer_;
-  mutable std::shared_ptr<uint8_t> rgb_buffer_;
-  mutable std::mutex mutex_;
   RTCVideoFrame::VideoRotation rotation_ = RTCVideoFrame::kVideoRotation_0;
+
+  struct PendingFrame {
+    scoped_refptr<RTCVideoFrame> frame;
+    uint64_t generation = 0;
+    // Steady-clock microseconds.
+    int64_t arrival_us = 0;
+  };
+
+  // Newest frame not yet picked up by the conversion thread. OnFrame runs on
+  // the decoder thread and never takes a lock unless the conversion thread
+  // is asleep on an empty slot and has to be woken.
+  LatestValueSlot<PendingFrame> pending_frame_;
+  // Bumped for every frame delivered to OnFrame. Decoder thread only.
+  uint64_t frame_generation_ = 0;
+  std::atomic<bool> conversion_waiting_{false};
+  std::atomic<bool> stop_conversion_{false};
+  mutable std::mutex wake_mutex_;
+  mutable std::condition_variable wake_cv_;
+  std::thread conversion_thread_;
+  // Hub the current track's frames come through.
+  std::mutex hub_mutex_;
+  scoped_refptr<FlutterVideoFrameHub> hub_;
+
+  std::shared_ptr<PixelBufferPool> buffer_pool_;
+  // Guards the published frames only, never a conversion.
+  mutable std::mutex buffer_mutex_;
+  mutable PublishedFrame front_;
+  mutable PublishedFrame ready_;
+  // Generation last returned from CopyPixelBuffer.
+  mutable uint64_t served_generation_ = 0;
+  // Set while |ready_| holds a frame the engine has been told about but not
+  // pulled yet.
+  mutable std::atomic<bool> ready_pending_{false};
+
+  std::atomic<FramePacing> pacing_{FramePacing::kLatestOnly};
+  std::atomic<int64_t> min_frame_interval_us_{0};
+  // Decoder thread only.
+  std::chrono::steady_clock::time_point next_frame_due_;
+
+  LatencyHistogram conversion_time_;
+  // From OnFrame to the engine picking the converted frame up.
+  mutable LatencyHistogram display_latency_;
+  std::atomic<int64_t> stats_interval_ms_{0};
+  // Conversion thread only.
+  int64_t last_stats_us_ = 0;
+
+  std::atomic<uint64_t> frames_delivered_{0};
+  mutable std::atomic<uint64_t> frames_rendered_{0};
+  std::atomic<uint64_t> frames_dropped_{0};
+
+  std::atomic<uint64_t> conversions_performed_{0};
+  mutable std::atomic<uint64_t> conversions_avoided_{0};
+  std::atomic<uint64_t> conversions_shared_{0};
+  std::atomic<uint64_t> conversions_parallel_{0};
+
+  std::atomic<bool> scale_to_display_{false};
+  // Last size requested by the engine, packed as width << 32 | height.
+  mutable std::atomic<uint64_t> display_size_{0};
+  std::atomic<bool> apply_rotation_{false};
+  std::atomic<int64_t> parallel_threshold_pixels_{
+      kDefaultParallelConversionPixels};
+  // Conversion thread only.
+  I420BandScratch band_scratch_;
 };
 
 class FlutterVideoRendererManager {
  public:
   FlutterVideoRendererManager(FlutterWebRTCBase* base);
+  ~FlutterVideoRendererManager();
 
   void CreateVideoRendererTexture(std::unique_ptr<MethodResultProxy> result);
 
@@ -73,9 +321,65 @@ class FlutterVideoRendererManager {
   void VideoRendererDispose(int64_t texture_id,
                             std::unique_ptr<MethodResultProxy> result);
 
+  void VideoRendererSetOptions(int64_t texture_id,
+                               const EncodableMap& options,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void VideoRendererGetStats(int64_t texture_id,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void VideoRendererGetPoolStats(std::unique_ptr<MethodResultProxy> result);
+
+  // Creates a texture showing several tracks at once. |params| holds the
+  // canvas "width" and "height", "trackIds" and an optional "layout".
+  void CreateCompositeRenderer(const EncodableMap& params,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  // Replaces the layout of a composite texture. Missing "width", "height"
+  // or "trackIds" keep their current values.
+  void CompositeRendererSetLayout(int64_t texture_id,
+                                  const EncodableMap& params,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  // Starts sampling thumbnails of "trackIds" every "intervalMs", replacing
+  // any sampler already running. See FlutterSnapshotSampler for the rest of
+  // |params|.
+  void StartSnapshotSampler(const EncodableMap& params,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  // Changes which tracks the running sampler covers.
+  void SnapshotSamplerSetTracks(const EncodableList& track_ids,
+                                std::unique_ptr<MethodResultProxy> result);
+
+  void StopSnapshotSampler(std::unique_ptr<MethodResultProxy> result);
+
+  // Routes |track|'s frames to |sink| through the track's shared hub,
+  // subscribing to the track when the first sink attaches.
+  scoped_refptr<FlutterVideoFrameHub> AttachToTrack(
+      scoped_refptr<RTCVideoTrack> track,
+      VideoFrameSink* sink);
+
+  // Unsubscribes from |track| when |sink| was the last one on it.
+  void DetachFromTrack(scoped_refptr<RTCVideoTrack> track,
+                       VideoFrameSink* sink);
+
  private:
   FlutterWebRTCBase* base_;
+  // RGBA buffers shared by every renderer created here.
+  std::shared_ptr<PixelBufferPool> buffer_pool_;
   std::map<int64_t, scoped_refptr<FlutterVideoRenderer>> renderers_;
+  std::map<RTCVideoTrack*, scoped_refptr<FlutterVideoFrameHub>> hubs_;
+  std::map<int64_t, scoped_refptr<FlutterCompositeRenderer>> composites_;
+  std::shared_ptr<FlutterSnapshotSampler> snapshot_sampler_;
+
+  // Resolves "trackIds" to video tracks, keeping a null entry for ids that
+  // are unknown or not video so positions still match the layout.
+  std::vector<scoped_refptr<RTCVideoTrack>> VideoTracksForIds(
+      const EncodableList& track_ids);
+
+  // As VideoTracksForIds, paired with the ids for the snapshot sampler.
+  std::vector<std::pair<std::string, scoped_refptr<RTCVideoTrack>>>
+  SnapshotTracksForIds(const EncodableList& track_ids);
 };
 
 }  // namespace flutter_webrtc_plugin
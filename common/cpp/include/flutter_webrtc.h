@@ -5,6 +5,7 @@
 
 #include "flutter_data_channel.h"
 #include "flutter_frame_cryptor.h"
+#include "flutter_media_recorder.h"
 #include "flutter_media_stream.h"
 #include "flutter_peerconnection.h"
 #include "flutter_screen_capture.h"
@@ -29,13 +30,269 @@ class FlutterWebRTC : public FlutterWebRTCBase,
                       public FlutterPeerConnection,
                       public FlutterScreenCapture,
                       public FlutterDataChannel,
-                      public FlutterFrameCryptor {
+                      public FlutterFrameCryptor,
+                      public FlutterMediaRecorderManager {
  public:
   FlutterWebRTC(FlutterWebRTCPlugin* plugin);
   virtual ~FlutterWebRTC();
 
   void HandleMethodCall(const MethodCallProxy& method_call,
                         std::unique_ptr<MethodResultProxy> result);
+
+ private:
+  typedef void (FlutterWebRTC::*MethodHandler)(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  struct MethodEntry {
+    std::string_view name;
+    MethodHandler handler;
+  };
+
+  // Returns the handler registered for |method_name|, or nullptr if the
+  // method is not handled here.
+  static MethodHandler FindMethodHandler(const std::string& method_name);
+
+  // Runs |method_name| through the handler tables, replying NotImplemented
+  // if nothing handles it. Shared by HandleMethodCall and executeBatch.
+  void Dispatch(const std::string& method_name,
+                const EncodableValue* arguments,
+                std::unique_ptr<MethodResultProxy> result);
+
+  void HandleInitialize(const EncodableValue* arguments,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreatePeerConnection(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetUserMedia(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetDisplayMedia(const EncodableValue* arguments,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetDesktopSources(const EncodableValue* arguments,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleUpdateDesktopSources(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetDesktopSourceThumbnail(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetSources(const EncodableValue* arguments,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSelectAudioInput(const EncodableValue* arguments,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSelectAudioOutput(const EncodableValue* arguments,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamGetTracks(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateOffer(const EncodableValue* arguments,
+                         std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateAnswer(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddStream(const EncodableValue* arguments,
+                       std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRemoveStream(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetLocalDescription(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetRemoteDescription(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddCandidate(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddCandidates(const EncodableValue* arguments,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetStats(const EncodableValue* arguments,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateDataChannel(const EncodableValue* arguments,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelSend(const EncodableValue* arguments,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelClose(const EncodableValue* arguments,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleStreamDispose(const EncodableValue* arguments,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamTrackSetEnable(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleTrackDispose(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRestartIce(const EncodableValue* arguments,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionClose(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionDispose(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateVideoRenderer(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererDispose(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererSetSrcObject(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererSetOptions(const EncodableValue* arguments,
+                                     std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererGetStats(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererGetPoolStats(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateCompositeRenderer(const EncodableValue* arguments,
+                                     std::unique_ptr<MethodResultProxy> result);
+
+  void HandleStartSnapshotSampler(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSnapshotSamplerSetTracks(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleStopSnapshotSampler(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCompositeRendererSetLayout(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamTrackSwitchCamera(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetVolume(const EncodableValue* arguments,
+                       std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetLocalDescription(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetRemoteDescription(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamAddTrack(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamRemoveTrack(const EncodableValue* arguments,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddTrack(const EncodableValue* arguments,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRemoveTrack(const EncodableValue* arguments,
+                         std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddTransceiver(const EncodableValue* arguments,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetTransceivers(const EncodableValue* arguments,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetReceivers(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetSenders(const EncodableValue* arguments,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderSetTrack(const EncodableValue* arguments,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderSetStreams(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderReplaceTrack(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderSetParameters(const EncodableValue* arguments,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpTransceiverStop(const EncodableValue* arguments,
+                                std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpTransceiverGetCurrentDirection(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpTransceiverSetDirection(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetConfiguration(const EncodableValue* arguments,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCaptureFrame(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleStartRecordToFile(const EncodableValue* arguments,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleStopRecordToFile(const EncodableValue* arguments,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateLocalMediaStream(const EncodableValue* arguments,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCanInsertDtmf(const EncodableValue* arguments,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSendDtmf(const EncodableValue* arguments,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetRtpSenderCapabilities(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetRtpReceiverCapabilities(
+      const EncodableValue* arguments,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetCodecPreferences(const EncodableValue* arguments,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetSignalingState(const EncodableValue* arguments,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetIceGatheringState(const EncodableValue* arguments,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetIceConnectionState(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetConnectionState(const EncodableValue* arguments,
+                                std::unique_ptr<MethodResultProxy> result);
+
+  // Runs a list of {method, args} operations in order and replies with a
+  // list of per-operation outcomes, optionally stopping at the first error.
+  void HandleExecuteBatch(const EncodableValue* arguments,
+                          std::unique_ptr<MethodResultProxy> result);
 };
 
 }  // namespace flutter_webrtc_plugin
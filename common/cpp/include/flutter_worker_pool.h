@@ -0,0 +1,49 @@
+#ifndef FLUTTER_WEBRTC_WORKER_POOL_HXX
+#define FLUTTER_WEBRTC_WORKER_POOL_HXX
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+// Small fixed set of background threads for CPU-bound work that must stay
+// off the platform, raster and WebRTC threads. Tasks run in FIFO order.
+class WorkerPool {
+ public:
+  // Process-wide pool, sized to leave at least one core for everything else
+  // and capped so it never dominates the machine.
+  static WorkerPool* Shared();
+
+  explicit WorkerPool(size_t threads);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  size_t size() const { return threads_.size(); }
+
+  void Post(std::function<void()> task);
+
+  // Runs |fn(i)| for every i in [0, count) on the pool and the calling
+  // thread, and returns once all of them have finished.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+ private:
+  void Run();
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_WORKER_POOL_HXX
@@ -0,0 +1,159 @@
+#ifndef FLUTTER_WEBRTC_YUV_CONVERTER_HXX
+#define FLUTTER_WEBRTC_YUV_CONVERTER_HXX
+
+#include "rtc_video_frame.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace flutter_webrtc_plugin {
+
+using namespace libwebrtc;
+
+class WorkerPool;
+
+// Byte order of the converted pixels in memory.
+enum class RgbaLayout {
+  // R, G, B, A. What Flutter pixel buffer textures and PNG expect; the same
+  // as RTCVideoFrame::Type::kABGR.
+  kRGBA,
+  // B, G, R, A. The same as RTCVideoFrame::Type::kARGB.
+  kBGRA,
+};
+
+// Borrowed view of the three planes of an I420 image.
+struct I420Planes {
+  const uint8_t* y = nullptr;
+  const uint8_t* u = nullptr;
+  const uint8_t* v = nullptr;
+  int stride_y = 0;
+  int stride_u = 0;
+  int stride_v = 0;
+  int width = 0;
+  int height = 0;
+};
+
+I420Planes I420PlanesFromFrame(const RTCVideoFrame& frame);
+
+// Converts BT.601 limited-range I420 to 32-bit RGB with opaque alpha. The
+// output matches libyuv's I420ToABGR/I420ToARGB bit for bit, which is what
+// RTCVideoFrame::ConvertToARGB uses. The SIMD path (AVX2, SSE2 or NEON) is
+// picked once at runtime from the CPU's features.
+void ConvertI420ToRgba(const I420Planes& src,
+                       RgbaLayout layout,
+                       uint8_t* dst,
+                       int dst_stride);
+
+// Working memory for ScaleI420ToRgba, kept by the caller so repeated scales
+// at a steady size do not allocate.
+struct I420ScaleScratch {
+  std::vector<uint8_t> planes;
+  std::vector<uint32_t> sums;
+  std::vector<int> columns;
+};
+
+// Box-filters |src| down to |dst_width| x |dst_height| directly in I420, then
+// converts the small image as ConvertI420ToRgba does. Only downscaling is
+// supported; the destination must not be larger than the source.
+void ScaleI420ToRgba(const I420Planes& src,
+                     int dst_width,
+                     int dst_height,
+                     RgbaLayout layout,
+                     uint8_t* dst,
+                     int dst_stride,
+                     I420ScaleScratch* scratch);
+
+// Produces only output rows [first_row, first_row + row_count) of
+// ScaleI420ToRgba, writing them to |dst|, which points at |first_row|.
+// |first_row| must be even so the band starts on a chroma row. Bands with
+// their own scratch can be converted concurrently.
+void ScaleI420ToRgbaRows(const I420Planes& src,
+                         int dst_width,
+                         int dst_height,
+                         int first_row,
+                         int row_count,
+                         RgbaLayout layout,
+                         uint8_t* dst,
+                         int dst_stride,
+                         I420ScaleScratch* scratch);
+
+// Scales |src| to |dst_width| x |dst_height| in I420, box-filtering when
+// shrinking and bilinear otherwise. The destination chroma planes are
+// half the size, rounded up.
+void ScaleI420(const I420Planes& src,
+               int dst_width,
+               int dst_height,
+               uint8_t* dst_y,
+               int dst_stride_y,
+               uint8_t* dst_u,
+               int dst_stride_u,
+               uint8_t* dst_v,
+               int dst_stride_v,
+               I420ScaleScratch* scratch);
+
+// Copies a 32-bit-per-pixel |width| x |height| image into |dst| rotated
+// clockwise by |rotation|. For 90 and 270 degrees |dst| is height x width.
+void RotateRgba(const uint8_t* src,
+                int src_stride,
+                int width,
+                int height,
+                RTCVideoFrame::VideoRotation rotation,
+                uint8_t* dst,
+                int dst_stride);
+
+// Working memory for ConvertI420ToRgbaBands, kept by the caller so repeated
+// conversions at a steady size do not allocate.
+struct I420BandScratch {
+  std::vector<I420ScaleScratch> bands;
+  std::vector<uint8_t> rotated;
+};
+
+// ScaleI420ToRgba at |width| x |height|, then RotateRgba by |rotation|, one
+// horizontal band of the unrotated output at a time. With more than one
+// band, the bands are converted side by side on |pool| and the calling
+// thread; each scales, converts and rotates its own rows, so they never
+// touch the same memory. |dst| is |height| x |width| for 90 and 270
+// degrees.
+void ConvertI420ToRgbaBands(const I420Planes& src,
+                            int width,
+                            int height,
+                            RTCVideoFrame::VideoRotation rotation,
+                            size_t bands,
+                            WorkerPool* pool,
+                            RgbaLayout layout,
+                            uint8_t* dst,
+                            int dst_stride,
+                            I420BandScratch* scratch);
+
+// Resamples a 32-bit-per-pixel image to |dst_width| x |dst_height| with
+// bilinear filtering. Meant for enlarging; ScaleI420ToRgba shrinks better,
+// since it averages every source pixel.
+void ResizeRgbaBilinear(const uint8_t* src,
+                        int src_stride,
+                        int src_width,
+                        int src_height,
+                        uint8_t* dst,
+                        int dst_stride,
+                        int dst_width,
+                        int dst_height);
+
+// Name of the conversion path selected for this CPU, e.g. "avx2".
+const char* YuvConverterBackend();
+
+// Names of every conversion path this CPU can run, best first; the last is
+// always "scalar".
+std::vector<std::string> YuvConverterBackends();
+
+// ConvertI420ToRgba through the named path instead of the selected one, so
+// the SIMD paths can be checked against the scalar one. Returns false if
+// this CPU cannot run |backend|.
+bool ConvertI420ToRgbaWithBackend(const std::string& backend,
+                                  const I420Planes& src,
+                                  RgbaLayout layout,
+                                  uint8_t* dst,
+                                  int dst_stride);
+
+}  // namespace flutter_webrtc_plugin
+
+#endif  // !FLUTTER_WEBRTC_YUV_CONVERTER_HXX
@@ -1,5 +1,19 @@
 #include "flutter_common.h"
 
+#include <assert.h>
+
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <vector>
+
+#if defined(_WINDOWS)
+#include <windows.h>
+#else
+#include <glib.h>
+#endif
+
 class MethodCallProxyImpl : public MethodCallProxy {
  public:
   explicit MethodCallProxyImpl(const MethodCall& method_call)
@@ -65,29 +79,402 @@ std::unique_ptr<MethodResultProxy> MethodResultProxy::Create(
   return std::make_unique<MethodResultProxyImpl>(std::move(method_result));
 }
 
+#if defined(_WINDOWS)
+
+// Tasks are posted to a message-only window created on the platform thread;
+// the window procedure runs them from the platform thread's message loop.
+class PlatformTaskRunner : public TaskRunner {
+ public:
+  PlatformTaskRunner() {
+    WNDCLASSW window_class = {};
+    window_class.lpfnWndProc = &PlatformTaskRunner::WndProc;
+    window_class.hInstance = GetModuleHandle(nullptr);
+    window_class.lpszClassName = kWindowClassName;
+    RegisterClassW(&window_class);
+    window_ = CreateWindowExW(0, kWindowClassName, L"", 0, 0, 0, 0, 0,
+                              HWND_MESSAGE, nullptr, window_class.hInstance,
+                              nullptr);
+  }
+
+  ~PlatformTaskRunner() override {
+    if (window_ != nullptr)
+      DestroyWindow(window_);
+  }
+
+  void EnqueueTask(std::function<void()> task) override {
+    auto* pending = new std::function<void()>(std::move(task));
+    if (!PostMessage(window_, kRunTaskMessage, 0,
+                     reinterpret_cast<LPARAM>(pending))) {
+      delete pending;
+    }
+  }
+
+  void EnqueueDelayedTask(std::function<void()> task,
+                          std::chrono::milliseconds delay) override {
+    // SetTimer only accepts windows owned by the calling thread, so arm the
+    // timer from the platform thread.
+    EnqueueTask([this, task = std::move(task), delay]() mutable {
+      UINT_PTR timer_id = next_timer_id_++;
+      timers_[timer_id] = std::move(task);
+      SetTimer(window_, timer_id, static_cast<UINT>(delay.count()), nullptr);
+    });
+  }
+
+ private:
+  static constexpr const wchar_t* kWindowClassName =
+      L"FlutterWebRTCTaskRunnerWindow";
+  static constexpr UINT kRunTaskMessage = WM_APP + 1;
+
+  static LRESULT CALLBACK WndProc(HWND window,
+                                  UINT message,
+                                  WPARAM wparam,
+                                  LPARAM lparam) {
+    if (message == kRunTaskMessage) {
+      std::unique_ptr<std::function<void()>> task(
+          reinterpret_cast<std::function<void()>*>(lparam));
+      (*task)();
+      return 0;
+    }
+    if (message == WM_TIMER) {
+      KillTimer(window, wparam);
+      auto* runner = static_cast<PlatformTaskRunner*>(TaskRunner::Platform());
+      auto it = runner->timers_.find(wparam);
+      if (it != runner->timers_.end()) {
+        std::function<void()> task = std::move(it->second);
+        runner->timers_.erase(it);
+        task();
+      }
+      return 0;
+    }
+    return DefWindowProcW(window, message, wparam, lparam);
+  }
+
+  HWND window_ = nullptr;
+  // Only touched on the platform thread.
+  UINT_PTR next_timer_id_ = 1;
+  std::map<UINT_PTR, std::function<void()>> timers_;
+};
+
+#else
+
+// The GTK embedder runs the platform thread on the default GLib main context.
+class PlatformTaskRunner : public TaskRunner {
+ public:
+  void EnqueueTask(std::function<void()> task) override {
+    g_idle_add_full(G_PRIORITY_DEFAULT, &PlatformTaskRunner::RunTask,
+                    new std::function<void()>(std::move(task)),
+                    &PlatformTaskRunner::DestroyTask);
+  }
+
+  void EnqueueDelayedTask(std::function<void()> task,
+                          std::chrono::milliseconds delay) override {
+    g_timeout_add_full(G_PRIORITY_DEFAULT, static_cast<guint>(delay.count()),
+                       &PlatformTaskRunner::RunTask,
+                       new std::function<void()>(std::move(task)),
+                       &PlatformTaskRunner::DestroyTask);
+  }
+
+ private:
+  static gboolean RunTask(gpointer data) {
+    (*static_cast<std::function<void()>*>(data))();
+    return G_SOURCE_REMOVE;
+  }
+
+  static void DestroyTask(gpointer data) {
+    delete static_cast<std::function<void()>*>(data);
+  }
+};
+
+#endif
+
+namespace {
+
+std::atomic<PlatformTaskRunner*> g_platform_runner{nullptr};
+std::thread::id g_platform_thread;
+
+}  // namespace
+
+void TaskRunner::InitializePlatform() {
+  if (g_platform_runner.load(std::memory_order_acquire) != nullptr) {
+    // Registering again, e.g. for a second engine, must not move the runner
+    // to another thread.
+    assert(g_platform_thread == std::this_thread::get_id());
+    return;
+  }
+  g_platform_thread = std::this_thread::get_id();
+  g_platform_runner.store(new PlatformTaskRunner(), std::memory_order_release);
+}
+
+TaskRunner* TaskRunner::Platform() {
+  PlatformTaskRunner* runner =
+      g_platform_runner.load(std::memory_order_acquire);
+  // Creating the runner lazily here could bind it to a libwebrtc thread,
+  // whose tasks would then never run.
+  assert(runner != nullptr);
+  return runner;
+}
+
+LatencyHistogram::LatencyHistogram() {
+  for (std::atomic<uint64_t>& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Record(std::chrono::microseconds value) {
+  uint64_t micros = value.count() > 0 ? uint64_t(value.count()) : 0;
+  buckets_[BucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t LatencyHistogram::PercentileMicros(double percentile) const {
+  uint64_t total = count();
+  if (total == 0)
+    return 0;
+  uint64_t rank = static_cast<uint64_t>(
+      std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * total));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (int i = 0; i < kBuckets; i++) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank)
+      return BucketUpperBound(i);
+  }
+  // Records racing with this walk; the top bucket is the safe answer.
+  return BucketUpperBound(kBuckets - 1);
+}
+
+// Values below kSubBuckets get a bucket each. Above that, every power of two
+// [2^m, 2^(m+1)) is split into kSubBuckets equal parts.
+int LatencyHistogram::BucketFor(uint64_t micros) {
+  if (micros < kSubBuckets)
+    return static_cast<int>(micros);
+  int msb = 0;
+  while (msb < 63 && (micros >> (msb + 1)))
+    msb++;
+  int sub = static_cast<int>((micros >> (msb - 2)) & (kSubBuckets - 1));
+  return std::min((msb - 1) * kSubBuckets + sub, kBuckets - 1);
+}
+
+int64_t LatencyHistogram::BucketUpperBound(int bucket) {
+  if (bucket < kSubBuckets)
+    return bucket;
+  int msb = bucket / kSubBuckets + 1;
+  int sub = bucket % kSubBuckets;
+  int64_t lower = int64_t(kSubBuckets + sub) << (msb - 2);
+  return lower + (int64_t(1) << (msb - 2)) - 1;
+}
+
+namespace {
+
+// Events that only report the latest value of some state. When one of these
+// is still queued, a newer event of the same kind replaces it.
+const char* kCoalescableEvents[] = {
+    "signalingState",          "iceGatheringState",
+    "iceConnectionState",      "peerConnectionState",
+    "didTextureChangeVideoSize", "didTextureChangeRotation",
+    "didTextureStats",
+};
+
+const std::string* CoalesceKey(const EncodableValue& event) {
+  const EncodableMap* map = std::get_if<EncodableMap>(&event);
+  if (map == nullptr)
+    return nullptr;
+  const std::string* name = findStringRef(*map, "event");
+  if (name == nullptr)
+    return nullptr;
+  for (const char* coalescable : kCoalescableEvents) {
+    if (*name == coalescable)
+      return name;
+  }
+  return nullptr;
+}
+
+
+// Unbounded multi-producer/single-consumer queue (Vyukov). Push never blocks
+// and may be called from any thread; Pop must only be called by one consumer.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  ~MpscQueue() {
+    T value;
+    while (Pop(&value)) {
+    }
+    if (tail_ != &stub_)
+      delete tail_;
+  }
+
+  void Push(T value) {
+    Node* node = new Node(std::move(value));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Returns false when the queue is empty, or when the newest push has not
+  // linked its node yet; that producer's own drain request will pick it up.
+  bool Pop(T* value) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr)
+      return false;
+    *value = std::move(next->value);
+    tail_ = next;
+    if (tail != &stub_)
+      delete tail;
+    return true;
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T v) : value(std::move(v)) {}
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  Node stub_;
+  std::atomic<Node*> head_;
+  Node* tail_;
+};
+
+}  // namespace
+
+// Fixed-capacity ring buffer of pending events. Coalesced events leave an
+// empty slot behind so the replacement keeps its place in the event order;
+// empty slots are reclaimed before anything live is evicted.
+class EventQueue {
+ public:
+  explicit EventQueue(const EventQueueOptions& options)
+      : options_(options), slots_(std::max<size_t>(options.capacity, 1)) {}
+
+  void Push(const EncodableValue& event) {
+    const std::string* key = CoalesceKey(event);
+    if (key != nullptr) {
+      auto it = pending_state_.find(*key);
+      if (it != pending_state_.end() && it->second >= head_) {
+        Slot& slot = slots_[Index(it->second)];
+        if (slot.live) {
+          slot.live = false;
+          slot.event = EncodableValue();
+          live_count_--;
+          coalesced_++;
+        }
+      }
+    }
+
+    if (tail_ - head_ == slots_.size() && live_count_ < slots_.size())
+      Compact();
+    if (tail_ - head_ == slots_.size()) {
+      dropped_++;
+      if (options_.overflow_policy ==
+          EventQueueOptions::OverflowPolicy::kDropNewest)
+        return;
+      Slot& oldest = slots_[Index(head_++)];
+      oldest.live = false;
+      oldest.event = EncodableValue();
+      live_count_--;
+    }
+
+    if (key != nullptr)
+      pending_state_[*key] = tail_;
+    Slot& slot = slots_[Index(tail_++)];
+    slot.event = event;
+    slot.live = true;
+    live_count_++;
+  }
+
+  // Hands every live event to |send| in order and empties the queue.
+  template <typename Send>
+  void Drain(Send send) {
+    for (; head_ != tail_; head_++) {
+      Slot& slot = slots_[Index(head_)];
+      if (slot.live) {
+        send(slot.event);
+        slot.live = false;
+        slot.event = EncodableValue();
+      }
+    }
+    live_count_ = 0;
+    pending_state_.clear();
+  }
+
+  size_t size() const { return live_count_; }
+  // Readable from any thread.
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  uint64_t coalesced() const {
+    return coalesced_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot {
+    EncodableValue event;
+    bool live = false;
+  };
+
+  size_t Index(uint64_t sequence) const { return sequence % slots_.size(); }
+
+  // Squeezes out the empty slots left behind by coalescing.
+  void Compact() {
+    uint64_t write = head_;
+    for (uint64_t read = head_; read != tail_; read++) {
+      Slot& slot = slots_[Index(read)];
+      if (!slot.live)
+        continue;
+      if (read != write) {
+        slots_[Index(write)] = std::move(slot);
+        slot.live = false;
+        slot.event = EncodableValue();
+      }
+      write++;
+    }
+    tail_ = write;
+    pending_state_.clear();
+    for (uint64_t seq = head_; seq != tail_; seq++) {
+      const std::string* key = CoalesceKey(slots_[Index(seq)].event);
+      if (key != nullptr)
+        pending_state_[*key] = seq;
+    }
+  }
+
+  EventQueueOptions options_;
+  std::vector<Slot> slots_;
+  // Monotonic sequence numbers; slot index is sequence % capacity.
+  uint64_t head_ = 0;
+  uint64_t tail_ = 0;
+  size_t live_count_ = 0;
+  // Sequence number of the queued event for each coalescable kind.
+  std::map<std::string, uint64_t> pending_state_;
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> coalesced_{0};
+};
+
 class EventChannelProxyImpl : public EventChannelProxy {
  public:
   EventChannelProxyImpl(BinaryMessenger* messenger,
-                        const std::string& channelName)
+                        const std::string& channelName,
+                        const EventQueueOptions& options)
       : channel_(std::make_unique<EventChannel>(
             messenger,
             channelName,
-            &flutter::StandardMethodCodec::GetInstance())) {
+            &flutter::StandardMethodCodec::GetInstance())),
+        options_(options),
+        event_queue_(options) {
     auto handler = std::make_unique<
         flutter::StreamHandlerFunctions<EncodableValue>>(
         [&](const EncodableValue* arguments,
             std::unique_ptr<flutter::EventSink<EncodableValue>>&& events)
             -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
           sink_ = std::move(events);
-          for (auto& event : event_queue_) {
-            sink_->Success(event);
-          }
-          event_queue_.clear();
           on_listen_called_ = true;
+          event_queue_.Drain(
+              [this](const EncodableValue& event) { Send(event); });
+          FlushBatch();
           return nullptr;
         },
         [&](const EncodableValue* arguments)
             -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+          FlushBatch();
           on_listen_called_ = false;
           return nullptr;
         });
@@ -98,24 +485,99 @@ class EventChannelProxyImpl : public EventChannelProxy {
   virtual ~EventChannelProxyImpl() {}
 
   void Success(const EncodableValue& event, bool cache_event = true) override {
-    if (on_listen_called_) {
+    pending_.Push(PendingEvent{event, cache_event});
+    if (!drain_scheduled_.exchange(true)) {
+      std::weak_ptr<int> alive = alive_;
+      TaskRunner::Platform()->EnqueueTask([this, alive]() {
+        // The proxy is destroyed on the platform thread too, so checking
+        // here cannot race with its destructor.
+        if (!alive.expired())
+          DrainPending();
+      });
+    }
+  }
+
+  uint64_t dropped_events() const override { return event_queue_.dropped(); }
+
+  uint64_t coalesced_events() const override {
+    return event_queue_.coalesced();
+  }
+
+ private:
+  struct PendingEvent {
+    EncodableValue event;
+    bool cache_event = true;
+  };
+
+  // Runs on the platform thread: the only place that touches sink_ and
+  // event_queue_ besides onListen.
+  void DrainPending() {
+    // Clear the flag before popping so a producer that pushes after the
+    // last Pop below schedules another drain instead of being stranded.
+    drain_scheduled_.store(false);
+    PendingEvent pending;
+    while (pending_.Pop(&pending)) {
+      if (on_listen_called_) {
+        Send(std::move(pending.event));
+      } else if (pending.cache_event) {
+        event_queue_.Push(pending.event);
+      }
+    }
+    if (!batch_.empty() && !flush_scheduled_) {
+      flush_scheduled_ = true;
+      std::weak_ptr<int> alive = alive_;
+      TaskRunner::Platform()->EnqueueDelayedTask(
+          [this, alive]() {
+            if (alive.expired())
+              return;
+            flush_scheduled_ = false;
+            FlushBatch();
+          },
+          options_.batch_window);
+    }
+  }
+
+  // Platform thread only.
+  void Send(EncodableValue event) {
+    if (!options_.batch_events) {
       sink_->Success(event);
+      return;
+    }
+    batch_.push_back(std::move(event));
+    if (batch_.size() >= options_.max_batch_size)
+      FlushBatch();
+  }
+
+  // Platform thread only.
+  void FlushBatch() {
+    if (batch_.empty() || !sink_)
+      return;
+    if (batch_.size() == 1) {
+      sink_->Success(batch_.front());
     } else {
-      if (cache_event) {
-        event_queue_.push_back(event);
-      }
+      sink_->Success(EncodableValue(std::move(batch_)));
     }
+    batch_ = EncodableList();
   }
 
- private:
   std::unique_ptr<EventChannel> channel_;
   std::unique_ptr<EventSink> sink_;
-  std::list<EncodableValue> event_queue_;
+  EventQueueOptions options_;
+  EventQueue event_queue_;
   bool on_listen_called_ = false;
+  // Events held back for the current batch, and whether its flush timer is
+  // armed.
+  EncodableList batch_;
+  bool flush_scheduled_ = false;
+  MpscQueue<PendingEvent> pending_;
+  std::atomic<bool> drain_scheduled_{false};
+  std::shared_ptr<int> alive_ = std::make_shared<int>(0);
 };
 
 std::unique_ptr<EventChannelProxy> EventChannelProxy::Create(
     BinaryMessenger* messenger,
-    const std::string& channelName) {
-  return std::make_unique<EventChannelProxyImpl>(messenger, channelName);
+    const std::string& channelName,
+    const EventQueueOptions& options) {
+  return std::make_unique<EventChannelProxyImpl>(messenger, channelName,
+                                                 options);
 }
@@ -0,0 +1,309 @@
+#include "flutter_composite_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+void FillOpaqueBlack(uint8_t* dst, int stride, int width, int height) {
+  static const uint8_t kBlack[4] = {0, 0, 0, 255};
+  for (int y = 0; y < height; y++) {
+    uint8_t* row = dst + static_cast<size_t>(y) * stride;
+    for (int x = 0; x < width; x++) {
+      memcpy(row + x * 4, kBlack, 4);
+    }
+  }
+}
+
+FlutterCompositeRenderer::Region ClipRegion(
+    const FlutterCompositeRenderer::Region& region,
+    size_t width,
+    size_t height) {
+  FlutterCompositeRenderer::Region clipped;
+  int right = std::min<int64_t>(int64_t(region.x) + region.width, width);
+  int bottom = std::min<int64_t>(int64_t(region.y) + region.height, height);
+  clipped.x = std::max(0, region.x);
+  clipped.y = std::max(0, region.y);
+  clipped.width = std::max(0, right - clipped.x);
+  clipped.height = std::max(0, bottom - clipped.y);
+  return clipped;
+}
+
+}  // namespace
+
+FlutterCompositeRenderer::~FlutterCompositeRenderer() {
+  StopComposeThread();
+}
+
+void FlutterCompositeRenderer::initialize(
+    TextureRegistrar* registrar,
+    std::unique_ptr<flutter::TextureVariant> texture,
+    int64_t texture_id,
+    FlutterVideoRendererManager* manager,
+    std::shared_ptr<PixelBufferPool> buffer_pool) {
+  registrar_ = registrar;
+  texture_ = std::move(texture);
+  texture_id_ = texture_id;
+  manager_ = manager;
+  buffer_pool_ = std::move(buffer_pool);
+  compose_thread_ =
+      std::thread(&FlutterCompositeRenderer::ComposeFrames, this);
+}
+
+const FlutterDesktopPixelBuffer* FlutterCompositeRenderer::CopyPixelBuffer(
+    size_t width,
+    size_t height) const {
+  std::lock_guard<std::mutex> lock(buffer_mutex_);
+  if (ready_) {
+    front_ = std::move(ready_);
+    ready_ = nullptr;
+  }
+  return front_ ? &front_->pixel_buffer : nullptr;
+}
+
+void FlutterCompositeRenderer::SetMaxFps(int max_fps) {
+  if (max_fps > 0)
+    compose_interval_us_ = 1000000 / max_fps;
+}
+
+void FlutterCompositeRenderer::SetLayout(
+    size_t width,
+    size_t height,
+    std::vector<scoped_refptr<RTCVideoTrack>> tracks,
+    std::vector<Region> regions) {
+  // Once detached, old sinks are guaranteed not to be inside OnRegionFrame,
+  // so region indices below always refer to the new layout.
+  for (size_t i = 0; i < sinks_.size(); i++) {
+    if (tracks_[i])
+      manager_->DetachFromTrack(tracks_[i], sinks_[i].get());
+  }
+  sinks_.clear();
+
+  for (Region& region : regions) {
+    region = ClipRegion(region, width, height);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    // Tracks that stay on screen keep their last frame, so a relayout does
+    // not blank them until their next frame arrives.
+    std::vector<scoped_refptr<RTCVideoFrame>> frames(regions.size());
+    for (size_t i = 0; i < frames.size() && i < tracks.size(); i++) {
+      for (size_t j = 0; j < tracks_.size() && j < frames_.size(); j++) {
+        if (tracks[i] && tracks[i] == tracks_[j]) {
+          frames[i] = frames_[j];
+          break;
+        }
+      }
+    }
+    canvas_width_ = width;
+    canvas_height_ = height;
+    regions_ = regions;
+    frames_ = std::move(frames);
+    dirty_.assign(regions_.size(), false);
+    relayout_ = true;
+  }
+  pending_cv_.notify_one();
+
+  width_ = width;
+  height_ = height;
+  tracks_ = std::move(tracks);
+  for (size_t i = 0; i < tracks_.size(); i++) {
+    sinks_.push_back(std::make_unique<RegionSink>(this, i));
+    if (tracks_[i] && i < regions.size())
+      manager_->AttachToTrack(tracks_[i], sinks_[i].get());
+  }
+}
+
+void FlutterCompositeRenderer::Clear() {
+  SetLayout(width_, height_, {}, {});
+}
+
+std::vector<FlutterCompositeRenderer::Region>
+FlutterCompositeRenderer::GridLayout(size_t count,
+                                     size_t width,
+                                     size_t height) {
+  std::vector<Region> regions;
+  if (count == 0)
+    return regions;
+  size_t columns = static_cast<size_t>(std::ceil(std::sqrt(double(count))));
+  size_t rows = (count + columns - 1) / columns;
+  for (size_t i = 0; i < count; i++) {
+    size_t column = i % columns;
+    size_t row = i / columns;
+    // Cell edges are rounded independently so the grid covers the whole
+    // canvas even when it does not divide evenly.
+    Region region;
+    region.x = static_cast<int>(column * width / columns);
+    region.y = static_cast<int>(row * height / rows);
+    region.width = static_cast<int>((column + 1) * width / columns) - region.x;
+    region.height = static_cast<int>((row + 1) * height / rows) - region.y;
+    regions.push_back(region);
+  }
+  return regions;
+}
+
+void FlutterCompositeRenderer::OnRegionFrame(
+    size_t index,
+    scoped_refptr<RTCVideoFrame> frame) {
+  {
+    // A region whose track outpaces the compositor only keeps its newest
+    // frame.
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    if (index >= frames_.size())
+      return;
+    frames_[index] = frame;
+    dirty_[index] = true;
+  }
+  pending_cv_.notify_one();
+}
+
+void FlutterCompositeRenderer::ComposeFrames() {
+  std::vector<std::pair<Region, scoped_refptr<RTCVideoFrame>>> draws;
+  while (true) {
+    size_t width = 0;
+    size_t height = 0;
+    bool relayout = false;
+    draws.clear();
+    {
+      std::unique_lock<std::mutex> lock(pending_mutex_);
+      pending_cv_.wait(lock, [this] {
+        return stop_compose_ || relayout_ ||
+               std::find(dirty_.begin(), dirty_.end(), true) != dirty_.end();
+      });
+      // Frames and layout changes arriving before the next composition is
+      // due are folded into it, so each source's frames do not each cost a
+      // full canvas copy.
+      pending_cv_.wait_until(lock, next_compose_,
+                             [this] { return stop_compose_; });
+      if (stop_compose_)
+        return;
+      auto now = std::chrono::steady_clock::now();
+      next_compose_ =
+          now + std::chrono::microseconds(compose_interval_us_.load());
+      width = canvas_width_;
+      height = canvas_height_;
+      relayout = relayout_;
+      relayout_ = false;
+      for (size_t i = 0; i < regions_.size(); i++) {
+        if ((relayout || dirty_[i]) && frames_[i])
+          draws.emplace_back(regions_[i], frames_[i]);
+        dirty_[i] = false;
+      }
+    }
+
+    if (relayout || width != drawn_width_ || height != drawn_height_) {
+      canvas_.resize(width * height * 4);
+      FillOpaqueBlack(canvas_.data(), static_cast<int>(width * 4),
+                      static_cast<int>(width), static_cast<int>(height));
+      drawn_width_ = width;
+      drawn_height_ = height;
+    }
+    if (width == 0 || height == 0)
+      continue;
+
+    for (const auto& draw : draws) {
+      DrawRegion(draw.first, draw.second);
+    }
+
+    // The canvas itself keeps being drawn into, so the engine gets a copy.
+    auto composed = std::make_shared<ConvertedVideoFrame>();
+    composed->pixels = buffer_pool_->Acquire(canvas_.size());
+    memcpy(composed->pixels.data(), canvas_.data(), canvas_.size());
+    composed->pixel_buffer.buffer = composed->pixels.data();
+    composed->pixel_buffer.width = width;
+    composed->pixel_buffer.height = height;
+    {
+      std::lock_guard<std::mutex> lock(buffer_mutex_);
+      ready_ = std::move(composed);
+    }
+    registrar_->MarkTextureFrameAvailable(texture_id_);
+  }
+}
+
+void FlutterCompositeRenderer::DrawRegion(
+    const Region& region,
+    const scoped_refptr<RTCVideoFrame>& frame) {
+  int canvas_stride = static_cast<int>(drawn_width_ * 4);
+  uint8_t* region_origin =
+      canvas_.data() + static_cast<size_t>(region.y) * canvas_stride +
+      static_cast<size_t>(region.x) * 4;
+  FillOpaqueBlack(region_origin, canvas_stride, region.width, region.height);
+
+  RTCVideoFrame::VideoRotation rotation = frame->rotation();
+  bool swap_sides = rotation == RTCVideoFrame::kVideoRotation_90 ||
+                    rotation == RTCVideoFrame::kVideoRotation_270;
+  int upright_width = swap_sides ? frame->height() : frame->width();
+  int upright_height = swap_sides ? frame->width() : frame->height();
+  if (region.width <= 0 || region.height <= 0 || upright_width <= 0 ||
+      upright_height <= 0) {
+    return;
+  }
+
+  // Letterbox inside the region, scaling the source up or down to fit.
+  double scale = std::min(double(region.width) / upright_width,
+                          double(region.height) / upright_height);
+  int fit_width = std::min(
+      region.width,
+      std::max(1, static_cast<int>(std::lround(upright_width * scale))));
+  int fit_height = std::min(
+      region.height,
+      std::max(1, static_cast<int>(std::lround(upright_height * scale))));
+  uint8_t* dst = region_origin +
+                 static_cast<size_t>((region.height - fit_height) / 2) *
+                     canvas_stride +
+                 static_cast<size_t>((region.width - fit_width) / 2) * 4;
+
+  if (fit_width > upright_width || fit_height > upright_height) {
+    // The I420 scaler only shrinks: convert at the source size, turn
+    // upright, then enlarge into place.
+    size_t pixels_size = static_cast<size_t>(frame->width()) *
+                         frame->height() * 4;
+    rotate_scratch_.resize(rotation == RTCVideoFrame::kVideoRotation_0
+                               ? pixels_size
+                               : pixels_size * 2);
+    uint8_t* pixels = rotate_scratch_.data();
+    ConvertI420ToRgba(I420PlanesFromFrame(*frame), RgbaLayout::kRGBA, pixels,
+                      frame->width() * 4);
+    if (rotation != RTCVideoFrame::kVideoRotation_0) {
+      uint8_t* upright = pixels + pixels_size;
+      RotateRgba(pixels, frame->width() * 4, frame->width(), frame->height(),
+                 rotation, upright, upright_width * 4);
+      pixels = upright;
+    }
+    ResizeRgbaBilinear(pixels, upright_width * 4, upright_width,
+                       upright_height, dst, canvas_stride, fit_width,
+                       fit_height);
+    return;
+  }
+
+  if (rotation == RTCVideoFrame::kVideoRotation_0) {
+    ScaleI420ToRgba(I420PlanesFromFrame(*frame), fit_width, fit_height,
+                    RgbaLayout::kRGBA, dst, canvas_stride, &scale_scratch_);
+    return;
+  }
+  int convert_width = swap_sides ? fit_height : fit_width;
+  int convert_height = swap_sides ? fit_width : fit_height;
+  rotate_scratch_.resize(static_cast<size_t>(convert_width) * convert_height *
+                         4);
+  ScaleI420ToRgba(I420PlanesFromFrame(*frame), convert_width, convert_height,
+                  RgbaLayout::kRGBA, rotate_scratch_.data(), convert_width * 4,
+                  &scale_scratch_);
+  RotateRgba(rotate_scratch_.data(), convert_width * 4, convert_width,
+             convert_height, rotation, dst, canvas_stride);
+}
+
+void FlutterCompositeRenderer::StopComposeThread() {
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    stop_compose_ = true;
+  }
+  pending_cv_.notify_one();
+  if (compose_thread_.joinable())
+    compose_thread_.join();
+}
+
+}  // namespace flutter_webrtc_plugin
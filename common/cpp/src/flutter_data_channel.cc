@@ -2,13 +2,17 @@
 
 #include <vector>
 
+#include "flutter_peerconnection.h"
+
 namespace flutter_webrtc_plugin {
 
 FlutterRTCDataChannelObserver::FlutterRTCDataChannelObserver(
     scoped_refptr<RTCDataChannel> data_channel,
     BinaryMessenger* messenger,
-    const std::string& channelName)
-    : event_channel_(EventChannelProxy::Create(messenger, channelName)),
+    const std::string& channelName,
+    const EventQueueOptions& event_options)
+    : event_channel_(
+          EventChannelProxy::Create(messenger, channelName, event_options)),
       data_channel_(data_channel) {
   data_channel_->RegisterObserver(this);
 }
@@ -52,9 +56,15 @@ void FlutterDataChannel::CreateDataChannel(
   std::string event_channel =
       "FlutterWebRTC/dataChannelEvent" + peerConnectionId + uuid;
 
+  // Batched only if the connection opted in; see CreateRTCPeerConnection.
+  EventQueueOptions event_options;
+  auto pc_observer = base_->peerconnection_observers_.find(peerConnectionId);
+  if (pc_observer != base_->peerconnection_observers_.end())
+    event_options = pc_observer->second->event_options();
+
   std::unique_ptr<FlutterRTCDataChannelObserver> observer(
       new FlutterRTCDataChannelObserver(data_channel, base_->messenger_,
-                                        event_channel));
+                                        event_channel, event_options));
 
   base_->lock();
   base_->data_channel_observers_[uuid] = std::move(observer);
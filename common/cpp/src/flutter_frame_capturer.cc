@@ -5,72 +5,186 @@
 #include "flutter_frame_capturer.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include "svpng.hpp"
+#include <mutex>
+#include <vector>
+#include "flutter_worker_pool.h"
+#include "flutter_yuv_converter.h"
 
 namespace flutter_webrtc_plugin {
 
-FlutterFrameCapturer::FlutterFrameCapturer(RTCVideoTrack* track,
-                                           std::string path) {
-  track_ = track;
-  path_ = path;
-}
+namespace {
 
-void FlutterFrameCapturer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
-  if (frame_ != nullptr) {
-    return;
+// Idle pixel and encode buffers kept between captures, so periodic
+// snapshots at a steady size stop allocating once the buffers have grown.
+class ScratchBuffers {
+ public:
+  static ScratchBuffers* Shared() {
+    static ScratchBuffers* buffers = new ScratchBuffers();
+    return buffers;
+  }
+
+  std::vector<uint8_t> Take() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.empty())
+      return std::vector<uint8_t>();
+    std::vector<uint8_t> buffer = std::move(idle_.back());
+    idle_.pop_back();
+    return buffer;
+  }
+
+  void Give(std::vector<uint8_t> buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < kMaxIdle)
+      idle_.push_back(std::move(buffer));
   }
 
-  frame_ = frame.get()->Copy();
-  catch_frame_ = true;
+ private:
+  // Two per capture in flight on a typical worker pool.
+  static constexpr size_t kMaxIdle = 8;
+
+  std::mutex mutex_;
+  std::vector<std::vector<uint8_t>> idle_;
+};
+
+const char* FormatName(const FrameCaptureOptions& options) {
+  if (options.raw_rgba)
+    return "rgba";
+  return options.encode.format == ImageFormat::kJpeg ? "jpeg" : "png";
 }
 
-void FlutterFrameCapturer::CaptureFrame(
-    std::unique_ptr<MethodResultProxy> result) {
-  mutex_.lock();
-  // Here init catch_frame_ flag
-  catch_frame_ = false;
+}  // namespace
+
+void FlutterFrameCapturer::Capture(scoped_refptr<RTCVideoTrack> track,
+                                   const FrameCaptureOptions& options,
+                                   std::unique_ptr<MethodResultProxy> result) {
+  auto capturer = std::make_shared<FlutterFrameCapturer>(track, options,
+                                                         std::move(result));
+  capturer->Start();
+}
 
+FlutterFrameCapturer::FlutterFrameCapturer(
+    scoped_refptr<RTCVideoTrack> track,
+    const FrameCaptureOptions& options,
+    std::unique_ptr<MethodResultProxy> result)
+    : track_(track), options_(options), result_(std::move(result)) {}
+
+void FlutterFrameCapturer::Start() {
+  // The track holds a raw pointer to us until Finish unregisters, so keep
+  // ourselves alive until then.
+  self_ = shared_from_this();
+  std::weak_ptr<FlutterFrameCapturer> weak_self = self_;
+  TaskRunner::Platform()->EnqueueDelayedTask(
+      [weak_self] {
+        if (auto self = weak_self.lock())
+          self->OnTimeout();
+      },
+      options_.timeout);
   track_->AddRenderer(this);
-  // Here waiting for catch_frame_ is set to true
-  while(!catch_frame_){}
-  // Here unlock the mutex
-  mutex_.unlock();
+}
 
-  mutex_.lock();
-  track_->RemoveRenderer(this);
+void FlutterFrameCapturer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
+  if (claimed_.exchange(true))
+    return;
+  // Never encode on the decoder thread; copy the frame so the decoder can
+  // reuse its buffer right away.
+  scoped_refptr<RTCVideoFrame> copy = frame->Copy();
+  std::shared_ptr<FlutterFrameCapturer> self = self_;
+  WorkerPool::Shared()->Post([self, copy] {
+    // Built here so the platform thread only has to hand it over.
+    auto value = std::make_shared<EncodableValue>();
+    bool ok = self->ProcessFrame(copy, value.get());
+    TaskRunner::Platform()->EnqueueTask([self, ok, value] {
+      self->Finish(ok, *value, "Cannot save the frame as an image file");
+    });
+  });
+}
 
-  bool success = SaveFrame();
-  mutex_.unlock();
+void FlutterFrameCapturer::OnTimeout() {
+  if (claimed_.exchange(true))
+    return;
+  Finish(false, EncodableValue(),
+         "captureFrame() timed out waiting for a frame");
+}
 
-  std::shared_ptr<MethodResultProxy> result_ptr(result.release());
-  if (success) {
-    result_ptr->Success();
+void FlutterFrameCapturer::Finish(bool ok,
+                                  const EncodableValue& value,
+                                  const std::string& error) {
+  track_->RemoveRenderer(this);
+  if (!ok) {
+    result_->Error("captureFrame", error);
+  } else if (options_.path.empty()) {
+    result_->Success(value);
   } else {
-    result_ptr->Error("1", "Cannot save the frame as .png file");
+    result_->Success();
   }
+  self_ = nullptr;
 }
 
-bool FlutterFrameCapturer::SaveFrame() {
-  if (frame_ == nullptr) {
+bool FlutterFrameCapturer::ProcessFrame(
+    const scoped_refptr<RTCVideoFrame>& frame,
+    EncodableValue* value) {
+  if (frame == nullptr) {
     return false;
   }
 
-  int width = frame_.get()->width();
-  int height = frame_.get()->height();
+  int width = frame->width();
+  int height = frame->height();
   int bytes_per_pixel = 4;
-  uint8_t* pixels = new uint8_t[width * height * bytes_per_pixel];
-
-  frame_.get()->ConvertToARGB(RTCVideoFrame::Type::kABGR, pixels,
-                              /* unused */ -1, width, height);
-
-  FILE* file = fopen(path_.c_str(), "wb");
-  if (!file) {
-    return false;
+  size_t pixels_size = size_t(width) * size_t(height) * bytes_per_pixel;
+  bool to_memory = options_.path.empty();
+
+  // Raw pixels bound for the method result are converted straight into the
+  // vector that becomes the result, skipping a copy.
+  std::vector<uint8_t> pixels = options_.raw_rgba && to_memory
+                                    ? std::vector<uint8_t>()
+                                    : ScratchBuffers::Shared()->Take();
+  pixels.resize(pixels_size);
+  ConvertI420ToRgba(I420PlanesFromFrame(*frame), RgbaLayout::kRGBA,
+                    pixels.data(), width * bytes_per_pixel);
+
+  std::vector<uint8_t> encoded;
+  if (!options_.raw_rgba) {
+    encoded = ScratchBuffers::Shared()->Take();
+    bool encoded_ok = EncodeImage(pixels.data(), width, height,
+                                  width * bytes_per_pixel, options_.encode,
+                                  &encoded);
+    ScratchBuffers::Shared()->Give(std::move(pixels));
+    if (!encoded_ok) {
+      ScratchBuffers::Shared()->Give(std::move(encoded));
+      return false;
+    }
+  } else {
+    encoded = std::move(pixels);
   }
 
-  svpng(file, width, height, pixels, 1);
-  fclose(file);
-  return true;
+  bool ok = true;
+  if (to_memory) {
+    EncodableMap map;
+    map[EncodableValue("width")] = EncodableValue(width);
+    map[EncodableValue("height")] = EncodableValue(height);
+    map[EncodableValue("format")] = EncodableValue(FormatName(options_));
+    if (options_.raw_rgba) {
+      map[EncodableValue("data")] = EncodableValue(std::move(encoded));
+    } else {
+      // The scratch buffer's capacity stays with the pool; the result gets
+      // an exactly sized copy.
+      map[EncodableValue("data")] = EncodableValue(
+          std::vector<uint8_t>(encoded.begin(), encoded.end()));
+    }
+    *value = EncodableValue(std::move(map));
+  } else {
+    FILE* file = fopen(options_.path.c_str(), "wb");
+    if (file) {
+      bool written =
+          fwrite(encoded.data(), 1, encoded.size(), file) == encoded.size();
+      ok = fclose(file) == 0 && written;
+    } else {
+      ok = false;
+    }
+  }
+  if (!options_.raw_rgba || !to_memory)
+    ScratchBuffers::Shared()->Give(std::move(encoded));
+  return ok;
 }
 
-}  // namespace flutter_webrtc_plugin
\ No newline at end of file
+}  // namespace flutter_webrtc_plugin
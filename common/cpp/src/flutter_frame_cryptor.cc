@@ -46,64 +46,64 @@ void FlutterFrameCryptorObserver::OnFrameCryptionStateChanged(
   event_channel_->Success(EncodableValue(params));
 }
 
+namespace {
+
+typedef void (FlutterFrameCryptor::*FrameCryptorMethodHandler)(
+    const EncodableMap& constraints,
+    std::unique_ptr<MethodResultProxy> result);
+
+struct FrameCryptorMethodEntry {
+  std::string_view name;
+  FrameCryptorMethodHandler handler;
+};
+
+// Must stay sorted by name, it is looked up with a binary search.
+constexpr FrameCryptorMethodEntry kFrameCryptorMethodHandlers[] = {
+    {"frameCryptorDispose", &FlutterFrameCryptor::FrameCryptorDispose},
+    {"frameCryptorFactoryCreateFrameCryptor",
+     &FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor},
+    {"frameCryptorFactoryCreateKeyProvider",
+     &FlutterFrameCryptor::FrameCryptorFactoryCreateKeyProvider},
+    {"frameCryptorGetEnabled", &FlutterFrameCryptor::FrameCryptorGetEnabled},
+    {"frameCryptorGetKeyIndex", &FlutterFrameCryptor::FrameCryptorGetKeyIndex},
+    {"frameCryptorSetEnabled", &FlutterFrameCryptor::FrameCryptorSetEnabled},
+    {"frameCryptorSetKeyIndex", &FlutterFrameCryptor::FrameCryptorSetKeyIndex},
+    {"keyProviderDispose", &FlutterFrameCryptor::KeyProviderDispose},
+    {"keyProviderExportKey", &FlutterFrameCryptor::KeyProviderExportKey},
+    {"keyProviderExportSharedKey",
+     &FlutterFrameCryptor::KeyProviderExportSharedKey},
+    {"keyProviderRatchetKey", &FlutterFrameCryptor::KeyProviderRatchetKey},
+    {"keyProviderRatchetSharedKey",
+     &FlutterFrameCryptor::KeyProviderRatchetSharedKey},
+    {"keyProviderSetKey", &FlutterFrameCryptor::KeyProviderSetKey},
+    {"keyProviderSetSharedKey", &FlutterFrameCryptor::KeyProviderSetSharedKey},
+    {"keyProviderSetSifTrailer",
+     &FlutterFrameCryptor::KeyProviderSetSifTrailer},
+};
+static_assert(IsSortedByName(kFrameCryptorMethodHandlers),
+              "kFrameCryptorMethodHandlers must be sorted by method name");
+
+}  // namespace
+
 bool FlutterFrameCryptor::HandleFrameCryptorMethodCall(
-    const MethodCallProxy& method_call,
-    std::unique_ptr<MethodResultProxy> result) {
-  const std::string& method_name = method_call.method_name();
-  if (!method_call.arguments()) {
+    const std::string& method_name,
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result,
+    std::unique_ptr<MethodResultProxy>* outResult) {
+  const FrameCryptorMethodEntry* entry =
+      FindByName(kFrameCryptorMethodHandlers, method_name);
+  if (entry == nullptr) {
+    *outResult = std::move(result);
+    return false;
+  }
+
+  if (!arguments) {
     result->Error("Bad Arguments", "Null arguments received");
     return true;
   }
-  const EncodableMap params = GetValue<EncodableMap>(*method_call.arguments());
-
-  if (method_name == "frameCryptorFactoryCreateFrameCryptor") {
-    FrameCryptorFactoryCreateFrameCryptor(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorSetKeyIndex") {
-    FrameCryptorSetKeyIndex(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorGetKeyIndex") {
-    FrameCryptorGetKeyIndex(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorSetEnabled") {
-    FrameCryptorSetEnabled(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorGetEnabled") {
-    FrameCryptorGetEnabled(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorDispose") {
-    FrameCryptorDispose(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorFactoryCreateKeyProvider") {
-    FrameCryptorFactoryCreateKeyProvider(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderSetSharedKey") {
-    KeyProviderSetSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderRatchetSharedKey") {
-    KeyProviderRatchetSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderExportSharedKey") {
-    KeyProviderExportSharedKey(params, std::move(result));
-    return true;
-  }else if (method_name == "keyProviderSetKey") {
-    KeyProviderSetKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderRatchetKey") {
-    KeyProviderRatchetKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderExportKey") {
-    KeyProviderExportKey(params, std::move(result));
-    return true;
-  }  else if (method_name == "keyProviderSetSifTrailer") {
-    KeyProviderSetSifTrailer(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderDispose") {
-    KeyProviderDispose(params, std::move(result));
-    return true;
-  }
-
-  return false;
+  const EncodableMap& params = GetValue<EncodableMap>(*arguments);
+  (this->*entry->handler)(params, std::move(result));
+  return true;
 }
 
 void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
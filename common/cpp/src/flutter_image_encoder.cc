@@ -0,0 +1,1135 @@
+#include "flutter_image_encoder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "flutter_worker_pool.h"
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+void PutBigEndian32(std::vector<uint8_t>* out, uint32_t value) {
+  out->push_back(uint8_t(value >> 24));
+  out->push_back(uint8_t(value >> 16));
+  out->push_back(uint8_t(value >> 8));
+  out->push_back(uint8_t(value));
+}
+
+void PutBigEndian16(std::vector<uint8_t>* out, uint32_t value) {
+  out->push_back(uint8_t(value >> 8));
+  out->push_back(uint8_t(value));
+}
+
+// ---------------------------------------------------------------------------
+// Checksums.
+
+const uint32_t* Crc32Table() {
+  static const struct Table {
+    uint32_t entries[256];
+    Table() {
+      for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+          c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        entries[i] = c;
+      }
+    }
+  } table;
+  return table.entries;
+}
+
+uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+  const uint32_t* table = Crc32Table();
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+constexpr uint32_t kAdlerBase = 65521;
+
+uint32_t Adler32(const uint8_t* data, size_t size) {
+  uint32_t a = 1;
+  uint32_t b = 0;
+  while (size > 0) {
+    // Largest run that cannot overflow b before the modulo.
+    size_t run = std::min<size_t>(size, 5552);
+    size -= run;
+    for (size_t i = 0; i < run; i++) {
+      a += data[i];
+      b += a;
+    }
+    data += run;
+    a %= kAdlerBase;
+    b %= kAdlerBase;
+  }
+  return (b << 16) | a;
+}
+
+// Checksum of two concatenated buffers from theirs, as zlib's
+// adler32_combine.
+uint32_t Adler32Combine(uint32_t adler1, uint32_t adler2, size_t size2) {
+  uint32_t rem = uint32_t(size2 % kAdlerBase);
+  uint32_t sum1 = adler1 & 0xffff;
+  uint32_t sum2 = uint32_t((uint64_t(rem) * sum1) % kAdlerBase);
+  sum1 += (adler2 & 0xffff) + kAdlerBase - 1;
+  sum2 += (adler1 >> 16) + (adler2 >> 16) + kAdlerBase - rem;
+  if (sum1 >= kAdlerBase)
+    sum1 -= kAdlerBase;
+  if (sum1 >= kAdlerBase)
+    sum1 -= kAdlerBase;
+  if (sum2 >= (kAdlerBase << 1))
+    sum2 -= (kAdlerBase << 1);
+  if (sum2 >= kAdlerBase)
+    sum2 -= kAdlerBase;
+  return sum1 | (sum2 << 16);
+}
+
+// ---------------------------------------------------------------------------
+// Deflate (RFC 1951): greedy hash-chain LZ77 and a dynamic Huffman code per
+// block.
+
+// Deflate packs bits least significant first.
+class DeflateBitWriter {
+ public:
+  explicit DeflateBitWriter(std::vector<uint8_t>* out) : out_(out) {}
+
+  // |count| is at most 16, so 32 bits of backlog always fit.
+  void Put(uint32_t value, int count) {
+    bits_ |= uint64_t(value) << count_;
+    count_ += count;
+    if (count_ >= 32) {
+      const uint8_t bytes[4] = {uint8_t(bits_), uint8_t(bits_ >> 8),
+                                uint8_t(bits_ >> 16), uint8_t(bits_ >> 24)};
+      out_->insert(out_->end(), bytes, bytes + 4);
+      bits_ >>= 32;
+      count_ -= 32;
+    }
+  }
+
+  // Pads to a byte boundary and writes out everything buffered.
+  void AlignToByte() {
+    count_ = (count_ + 7) & ~7;
+    for (; count_ > 0; count_ -= 8) {
+      out_->push_back(uint8_t(bits_));
+      bits_ >>= 8;
+    }
+    bits_ = 0;
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+  uint64_t bits_ = 0;
+  int count_ = 0;
+};
+
+constexpr int kLengthSymbols = 29;
+constexpr int kDistanceSymbols = 30;
+constexpr int kLitLenSymbols = 286;
+constexpr int kMaxCodeBits = 15;
+constexpr int kMaxCodeLengthBits = 7;
+
+constexpr uint16_t kLengthBase[kLengthSymbols] = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[kLengthSymbols] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistanceBase[kDistanceSymbols] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistanceExtra[kDistanceSymbols] = {
+    0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                          11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+int LengthSymbol(int length) {
+  static const struct Table {
+    uint8_t symbols[259];
+    Table() {
+      for (int s = 0; s < kLengthSymbols; s++) {
+        int end = s + 1 < kLengthSymbols ? kLengthBase[s + 1] : 259;
+        for (int length = kLengthBase[s]; length < end; length++)
+          symbols[length] = uint8_t(s);
+      }
+      // 258 has a code of its own rather than being 227 + 31.
+      symbols[258] = kLengthSymbols - 1;
+    }
+  } table;
+  return table.symbols[length];
+}
+
+int DistanceSymbol(int distance) {
+  // As zlib's _dist_code: exact for the first 256 distances, then by steps
+  // of 128, which no symbol boundary above 256 splits.
+  static const struct Table {
+    uint8_t symbols[512];
+    Table() {
+      for (int s = 0; s < kDistanceSymbols; s++) {
+        int end = s + 1 < kDistanceSymbols ? kDistanceBase[s + 1] : 32769;
+        for (int d = kDistanceBase[s]; d < end; d++) {
+          if (d <= 256)
+            symbols[d - 1] = uint8_t(s);
+          else
+            symbols[256 + ((d - 1) >> 7)] = uint8_t(s);
+        }
+      }
+    }
+  } table;
+  return distance <= 256 ? table.symbols[distance - 1]
+                         : table.symbols[256 + ((distance - 1) >> 7)];
+}
+
+// Huffman code lengths for |freqs|, no longer than |max_bits|. Symbols with
+// zero frequency get no code. At least two symbols always get one, as
+// inflaters expect a complete code.
+void BuildCodeLengths(const uint32_t* freqs,
+                      int count,
+                      int max_bits,
+                      uint8_t* lengths) {
+  std::vector<int> used;
+  for (int i = 0; i < count; i++) {
+    lengths[i] = 0;
+    if (freqs[i])
+      used.push_back(i);
+  }
+  for (int i = 0; used.size() < 2 && i < count; i++) {
+    if (!freqs[i])
+      used.push_back(i);
+  }
+
+  // Plain Huffman tree; only the depth of each leaf is kept.
+  struct Node {
+    uint64_t freq;
+    int index;
+    bool operator>(const Node& other) const {
+      return freq != other.freq ? freq > other.freq : index > other.index;
+    }
+  };
+  std::vector<int> parent(used.size() * 2, -1);
+  std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+  for (size_t i = 0; i < used.size(); i++)
+    queue.push({std::max<uint64_t>(freqs[used[i]], 1), int(i)});
+  int next = int(used.size());
+  while (queue.size() > 1) {
+    Node a = queue.top();
+    queue.pop();
+    Node b = queue.top();
+    queue.pop();
+    parent[a.index] = next;
+    parent[b.index] = next;
+    queue.push({a.freq + b.freq, next++});
+  }
+  std::vector<int> depth(next, 0);
+  for (int node = next - 2; node >= 0; node--)
+    depth[node] = depth[parent[node]] + 1;
+
+  // Count codes per length, folding over-long ones into |max_bits| and then
+  // rebalancing until the code is complete again (as miniz does).
+  std::vector<int> per_length(std::max(max_bits, 32) + 1, 0);
+  for (size_t i = 0; i < used.size(); i++)
+    per_length[std::min(depth[i], max_bits)]++;
+  uint32_t total = 0;
+  for (int bits = max_bits; bits > 0; bits--)
+    total += uint32_t(per_length[bits]) << (max_bits - bits);
+  while (total > (1u << max_bits)) {
+    per_length[max_bits]--;
+    for (int bits = max_bits - 1; bits > 0; bits--) {
+      if (per_length[bits]) {
+        per_length[bits]--;
+        per_length[bits + 1] += 2;
+        break;
+      }
+    }
+    total--;
+  }
+
+  // Most frequent symbols get the shortest codes.
+  std::vector<int> order(used.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = int(i);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return freqs[used[a]] > freqs[used[b]];
+  });
+  size_t position = 0;
+  for (int bits = 1; bits <= max_bits; bits++) {
+    for (int n = 0; n < per_length[bits]; n++)
+      lengths[used[order[position++]]] = uint8_t(bits);
+  }
+}
+
+// Canonical codes for |lengths|, bit-reversed for DeflateBitWriter.
+void BuildCodes(const uint8_t* lengths, int count, uint16_t* codes) {
+  int per_length[kMaxCodeBits + 1] = {};
+  for (int i = 0; i < count; i++)
+    per_length[lengths[i]]++;
+  per_length[0] = 0;
+  int next_code[kMaxCodeBits + 2] = {};
+  int code = 0;
+  for (int bits = 1; bits <= kMaxCodeBits; bits++) {
+    code = (code + per_length[bits - 1]) << 1;
+    next_code[bits] = code;
+  }
+  for (int i = 0; i < count; i++) {
+    int bits = lengths[i];
+    if (bits == 0)
+      continue;
+    int value = next_code[bits]++;
+    int reversed = 0;
+    for (int b = 0; b < bits; b++)
+      reversed |= ((value >> b) & 1) << (bits - 1 - b);
+    codes[i] = uint16_t(reversed);
+  }
+}
+
+// An LZ77 output token: a literal when |distance| is zero, otherwise a
+// back-reference of |value| bytes.
+struct LzToken {
+  uint16_t value;
+  uint16_t distance;
+};
+
+// Writes |tokens|, which encode |raw_size| bytes, as one dynamic block.
+// Returns false without writing anything when the block would be no smaller
+// than storing the bytes.
+bool WriteDynamicBlock(const std::vector<LzToken>& tokens,
+                       size_t raw_size,
+                       DeflateBitWriter* writer) {
+  uint32_t litlen_freqs[kLitLenSymbols] = {};
+  uint32_t distance_freqs[kDistanceSymbols] = {};
+  for (const LzToken& token : tokens) {
+    if (token.distance == 0) {
+      litlen_freqs[token.value]++;
+    } else {
+      litlen_freqs[257 + LengthSymbol(token.value)]++;
+      distance_freqs[DistanceSymbol(token.distance)]++;
+    }
+  }
+  litlen_freqs[256] = 1;
+
+  uint8_t litlen_lengths[kLitLenSymbols];
+  uint8_t distance_lengths[kDistanceSymbols];
+  BuildCodeLengths(litlen_freqs, kLitLenSymbols, kMaxCodeBits, litlen_lengths);
+  BuildCodeLengths(distance_freqs, kDistanceSymbols, kMaxCodeBits,
+                   distance_lengths);
+  int litlen_count = kLitLenSymbols;
+  while (litlen_count > 257 && litlen_lengths[litlen_count - 1] == 0)
+    litlen_count--;
+  int distance_count = kDistanceSymbols;
+  while (distance_count > 1 && distance_lengths[distance_count - 1] == 0)
+    distance_count--;
+  // The two code length sequences are sent as one.
+  uint8_t lengths[kLitLenSymbols + kDistanceSymbols];
+  memcpy(lengths, litlen_lengths, litlen_count);
+  memcpy(lengths + litlen_count, distance_lengths, distance_count);
+  int total_lengths = litlen_count + distance_count;
+
+  // Run-length code the code lengths with symbols 16 (repeat previous),
+  // 17 and 18 (runs of zeros).
+  struct LengthToken {
+    uint8_t symbol;
+    uint8_t extra;
+  };
+  std::vector<LengthToken> length_tokens;
+  uint32_t length_freqs[19] = {};
+  for (int i = 0; i < total_lengths;) {
+    uint8_t value = lengths[i];
+    int run = 1;
+    while (i + run < total_lengths && lengths[i + run] == value)
+      run++;
+    i += run;
+    if (value == 0) {
+      while (run >= 11) {
+        int n = std::min(run, 138);
+        length_tokens.push_back({18, uint8_t(n - 11)});
+        run -= n;
+      }
+      if (run >= 3) {
+        length_tokens.push_back({17, uint8_t(run - 3)});
+        run = 0;
+      }
+    } else {
+      length_tokens.push_back({value, 0});
+      run--;
+      while (run >= 3) {
+        int n = std::min(run, 6);
+        length_tokens.push_back({16, uint8_t(n - 3)});
+        run -= n;
+      }
+    }
+    for (; run > 0; run--)
+      length_tokens.push_back({value, 0});
+  }
+  for (const LengthToken& token : length_tokens)
+    length_freqs[token.symbol]++;
+  uint8_t length_code_lengths[19];
+  uint16_t length_codes[19] = {};
+  BuildCodeLengths(length_freqs, 19, kMaxCodeLengthBits, length_code_lengths);
+  BuildCodes(length_code_lengths, 19, length_codes);
+  int length_code_count = 19;
+  while (length_code_count > 4 &&
+         length_code_lengths[kCodeLengthOrder[length_code_count - 1]] == 0)
+    length_code_count--;
+
+  uint16_t litlen_codes[kLitLenSymbols] = {};
+  uint16_t distance_codes[kDistanceSymbols] = {};
+  BuildCodes(litlen_lengths, kLitLenSymbols, litlen_codes);
+  BuildCodes(distance_lengths, kDistanceSymbols, distance_codes);
+
+  // Header, code lengths and data, as written below.
+  uint64_t bits = 17 + 3 * length_code_count;
+  for (const LengthToken& token : length_tokens) {
+    // Symbols 16, 17 and 18 carry 2, 3 and 7 extra bits.
+    static const uint8_t kRepeatExtra[3] = {2, 3, 7};
+    bits += length_code_lengths[token.symbol];
+    if (token.symbol >= 16)
+      bits += kRepeatExtra[token.symbol - 16];
+  }
+  for (int s = 0; s < kLitLenSymbols; s++) {
+    bits += uint64_t(litlen_freqs[s]) *
+            (litlen_lengths[s] + (s > 256 ? kLengthExtra[s - 257] : 0));
+  }
+  for (int s = 0; s < kDistanceSymbols; s++) {
+    bits += uint64_t(distance_freqs[s]) *
+            (distance_lengths[s] + kDistanceExtra[s]);
+  }
+  // A stored block costs five bytes per 64K on top of the data.
+  if (bits / 8 >= raw_size + (raw_size / 65535 + 1) * 5)
+    return false;
+
+  // Block header: not final, dynamic Huffman.
+  writer->Put(0, 1);
+  writer->Put(2, 2);
+  writer->Put(litlen_count - 257, 5);
+  writer->Put(distance_count - 1, 5);
+  writer->Put(length_code_count - 4, 4);
+  for (int i = 0; i < length_code_count; i++)
+    writer->Put(length_code_lengths[kCodeLengthOrder[i]], 3);
+  for (const LengthToken& token : length_tokens) {
+    writer->Put(length_codes[token.symbol],
+                length_code_lengths[token.symbol]);
+    if (token.symbol == 16)
+      writer->Put(token.extra, 2);
+    else if (token.symbol == 17)
+      writer->Put(token.extra, 3);
+    else if (token.symbol == 18)
+      writer->Put(token.extra, 7);
+  }
+
+  for (const LzToken& token : tokens) {
+    if (token.distance == 0) {
+      writer->Put(litlen_codes[token.value], litlen_lengths[token.value]);
+      continue;
+    }
+    int length_symbol = LengthSymbol(token.value);
+    writer->Put(litlen_codes[257 + length_symbol],
+                litlen_lengths[257 + length_symbol]);
+    writer->Put(token.value - kLengthBase[length_symbol],
+                kLengthExtra[length_symbol]);
+    int distance_symbol = DistanceSymbol(token.distance);
+    writer->Put(distance_codes[distance_symbol],
+                distance_lengths[distance_symbol]);
+    writer->Put(token.distance - kDistanceBase[distance_symbol],
+                kDistanceExtra[distance_symbol]);
+  }
+  writer->Put(litlen_codes[256], litlen_lengths[256]);
+  return true;
+}
+
+// Writes |data| as non-final stored blocks.
+void WriteStoredBlocks(const uint8_t* data,
+                       size_t size,
+                       DeflateBitWriter* writer,
+                       std::vector<uint8_t>* out) {
+  while (size > 0) {
+    size_t length = std::min<size_t>(size, 65535);
+    writer->Put(0, 3);
+    writer->AlignToByte();
+    out->insert(out->end(), {uint8_t(length), uint8_t(length >> 8),
+                             uint8_t(~length), uint8_t(~length >> 8)});
+    out->insert(out->end(), data, data + length);
+    data += length;
+    size -= length;
+  }
+}
+
+constexpr int kHashBits = 15;
+constexpr int kWindowSize = 32768;
+constexpr int kMinMatch = 3;
+constexpr int kMaxMatch = 258;
+constexpr int kMaxChain = 4;
+// A match this long is taken without searching the rest of the chain.
+constexpr int kNiceMatch = 64;
+constexpr size_t kTokensPerBlock = 1 << 16;
+
+// Number of leading bytes |a| and |b| share, up to |max_length|. Compares
+// eight bytes at a time while they agree.
+int MatchLength(const uint8_t* a, const uint8_t* b, int max_length) {
+  int length = 0;
+  for (; length + 8 <= max_length; length += 8) {
+    uint64_t x;
+    uint64_t y;
+    memcpy(&x, a + length, 8);
+    memcpy(&y, b + length, 8);
+    if (x != y)
+      break;
+  }
+  while (length < max_length && a[length] == b[length])
+    length++;
+  return length;
+}
+
+// Deflates |data| into |out| as non-final blocks followed by an empty stored
+// block, so the result ends byte-aligned and can be concatenated with other
+// independently deflated pieces (a "sync flush"). Once a block fails to
+// shrink, as on sensor noise, the rest is stored without searching for
+// matches.
+void DeflateChunk(const uint8_t* data,
+                  size_t size,
+                  std::vector<uint8_t>* out) {
+  DeflateBitWriter writer(out);
+  std::vector<int32_t> head(1 << kHashBits, -1);
+  std::vector<int32_t> prev(kWindowSize, -1);
+  std::vector<LzToken> tokens;
+  tokens.reserve(kTokensPerBlock);
+  auto hash = [&](size_t pos) {
+    uint32_t v = uint32_t(data[pos]) << 16 | uint32_t(data[pos + 1]) << 8 |
+                 data[pos + 2];
+    return (v * 2654435761u) >> (32 - kHashBits);
+  };
+  auto insert = [&](size_t pos) {
+    uint32_t h = hash(pos);
+    prev[pos & (kWindowSize - 1)] = head[h];
+    head[h] = int32_t(pos);
+  };
+
+  size_t pos = 0;
+  size_t block_start = 0;
+  bool incompressible = false;
+  auto write_block = [&]() {
+    if (!WriteDynamicBlock(tokens, pos - block_start, &writer)) {
+      WriteStoredBlocks(data + block_start, pos - block_start, &writer, out);
+      incompressible = true;
+    }
+    tokens.clear();
+    block_start = pos;
+  };
+  while (pos < size && !incompressible) {
+    int best_length = 0;
+    int best_distance = 0;
+    if (pos + kMinMatch <= size) {
+      int max_length = int(std::min<size_t>(kMaxMatch, size - pos));
+      int32_t candidate = head[hash(pos)];
+      for (int chain = 0; candidate >= 0 && chain < kMaxChain; chain++) {
+        int distance = int(pos - candidate);
+        if (distance > kWindowSize)
+          break;
+        const uint8_t* a = data + candidate;
+        const uint8_t* b = data + pos;
+        if (a[best_length] == b[best_length]) {
+          int length = MatchLength(a, b, max_length);
+          if (length > best_length) {
+            best_length = length;
+            best_distance = distance;
+            // Nothing longer can be found, and probing a[best_length] at
+            // the end of the input would read past it.
+            if (length >= kNiceMatch || length == max_length)
+              break;
+          }
+        }
+        int32_t next = prev[candidate & (kWindowSize - 1)];
+        // Slots are reused as the window slides; stop at stale links.
+        if (next >= candidate)
+          break;
+        candidate = next;
+      }
+      insert(pos);
+    }
+    if (best_length >= kMinMatch) {
+      tokens.push_back({uint16_t(best_length), uint16_t(best_distance)});
+      for (size_t end = pos + best_length, p = pos + 1; p < end; p++) {
+        if (p + kMinMatch <= size)
+          insert(p);
+      }
+      pos += best_length;
+    } else {
+      tokens.push_back({data[pos], 0});
+      pos++;
+    }
+    if (tokens.size() == kTokensPerBlock)
+      write_block();
+  }
+  if (!tokens.empty())
+    write_block();
+  WriteStoredBlocks(data + pos, size - pos, &writer, out);
+  // Empty stored block: header, then LEN 0 and NLEN 0xffff.
+  writer.Put(0, 3);
+  writer.AlignToByte();
+  out->insert(out->end(), {0x00, 0x00, 0xff, 0xff});
+}
+
+// ---------------------------------------------------------------------------
+// PNG.
+
+// Written without branches: the neighbours of noisy pixels make the choice
+// unpredictable.
+uint8_t Paeth(int a, int b, int c) {
+  // |p - a|, |p - b| and |p - c| for p = a + b - c.
+  int pa = std::abs(b - c);
+  int pb = std::abs(a - c);
+  int pc = std::abs(a + b - 2 * c);
+  int bc = pb <= pc ? b : c;
+  return uint8_t(pa <= pb && pa <= pc ? a : bc);
+}
+
+// Writes one filtered scanline (filter byte plus data) for |row|, picking
+// the filter with the smallest sum of absolute residuals, the heuristic
+// libpng uses. |previous| is all zeros for the first row of the image.
+void FilterRow(const uint8_t* row,
+               const uint8_t* previous,
+               size_t size,
+               uint8_t* out) {
+  constexpr size_t kBpp = 3;
+  // Score every filter, then produce only the winner. One loop per filter
+  // keeps each simple enough for the compiler to vectorize. The first pixel
+  // has no left neighbour and is scored as if it were zero.
+  auto cost = [](int residual) {
+    return uint32_t(std::abs(int(int8_t(residual))));
+  };
+  uint32_t costs[5] = {};
+  for (size_t i = 0; i < kBpp; i++) {
+    costs[0] += cost(row[i]);
+    costs[1] += cost(row[i]);
+    costs[2] += cost(row[i] - previous[i]);
+    costs[3] += cost(row[i] - (previous[i] >> 1));
+    costs[4] += cost(row[i] - previous[i]);
+  }
+  uint32_t sum = 0;
+  for (size_t i = kBpp; i < size; i++)
+    sum += cost(row[i]);
+  costs[0] += sum;
+  sum = 0;
+  for (size_t i = kBpp; i < size; i++)
+    sum += cost(row[i] - row[i - kBpp]);
+  costs[1] += sum;
+  sum = 0;
+  for (size_t i = kBpp; i < size; i++)
+    sum += cost(row[i] - previous[i]);
+  costs[2] += sum;
+  sum = 0;
+  for (size_t i = kBpp; i < size; i++)
+    sum += cost(row[i] - ((row[i - kBpp] + previous[i]) >> 1));
+  costs[3] += sum;
+  sum = 0;
+  for (size_t i = kBpp; i < size; i++)
+    sum +=
+        cost(row[i] - Paeth(row[i - kBpp], previous[i], previous[i - kBpp]));
+  costs[4] += sum;
+  int best = int(std::min_element(costs, costs + 5) - costs);
+
+  out[0] = uint8_t(best);
+  out++;
+  switch (best) {
+    case 0:
+      memcpy(out, row, size);
+      break;
+    case 1:
+      memcpy(out, row, kBpp);
+      for (size_t i = kBpp; i < size; i++)
+        out[i] = uint8_t(row[i] - row[i - kBpp]);
+      break;
+    case 2:
+      for (size_t i = 0; i < size; i++)
+        out[i] = uint8_t(row[i] - previous[i]);
+      break;
+    case 3:
+      for (size_t i = 0; i < kBpp; i++)
+        out[i] = uint8_t(row[i] - (previous[i] >> 1));
+      for (size_t i = kBpp; i < size; i++)
+        out[i] = uint8_t(row[i] - ((row[i - kBpp] + previous[i]) >> 1));
+      break;
+    default:
+      for (size_t i = 0; i < kBpp; i++)
+        out[i] = uint8_t(row[i] - previous[i]);
+      for (size_t i = kBpp; i < size; i++) {
+        out[i] = uint8_t(
+            row[i] - Paeth(row[i - kBpp], previous[i], previous[i - kBpp]));
+      }
+      break;
+  }
+}
+
+void DropAlpha(const uint8_t* rgba, int width, uint8_t* rgb) {
+  for (int x = 0; x < width; x++) {
+    rgb[x * 3] = rgba[x * 4];
+    rgb[x * 3 + 1] = rgba[x * 4 + 1];
+    rgb[x * 3 + 2] = rgba[x * 4 + 2];
+  }
+}
+
+void PutPngChunk(std::vector<uint8_t>* out,
+                 const char* type,
+                 const uint8_t* data,
+                 size_t size) {
+  PutBigEndian32(out, uint32_t(size));
+  size_t start = out->size();
+  out->insert(out->end(), type, type + 4);
+  if (size > 0)
+    out->insert(out->end(), data, data + size);
+  PutBigEndian32(out, Crc32(0, out->data() + start, size + 4));
+}
+
+// Fewest rows per independently filtered and deflated band.
+constexpr int kMinPngBandRows = 32;
+
+bool EncodePng(const uint8_t* rgba,
+               int width,
+               int height,
+               int stride,
+               std::vector<uint8_t>* out) {
+  const size_t row_size = size_t(width) * 3;
+  const size_t filtered_row_size = row_size + 1;
+
+  WorkerPool* pool = WorkerPool::Shared();
+  int bands = int(std::min<size_t>((pool->size() + 1) * 2,
+                                   size_t(height / kMinPngBandRows)));
+  bands = std::max(bands, 1);
+  int band_rows = (height + bands - 1) / bands;
+
+  struct Band {
+    std::vector<uint8_t> deflated;
+    uint32_t adler = 1;
+    size_t filtered_size = 0;
+  };
+  std::vector<Band> results(bands);
+  pool->ParallelFor(size_t(bands), [&](size_t band) {
+    int first_row = int(band) * band_rows;
+    int rows = std::min(band_rows, height - first_row);
+    if (rows <= 0)
+      return;
+    std::vector<uint8_t> filtered(filtered_row_size * rows);
+    std::vector<uint8_t> current(row_size);
+    std::vector<uint8_t> previous(row_size);
+    if (first_row > 0)
+      DropAlpha(rgba + size_t(first_row - 1) * stride, width, previous.data());
+    for (int r = 0; r < rows; r++) {
+      int y = first_row + r;
+      DropAlpha(rgba + size_t(y) * stride, width, current.data());
+      FilterRow(current.data(), previous.data(), row_size,
+                filtered.data() + filtered_row_size * r);
+      std::swap(current, previous);
+    }
+    Band& result = results[band];
+    result.filtered_size = filtered.size();
+    result.adler = Adler32(filtered.data(), filtered.size());
+    result.deflated.reserve(filtered.size() / 2);
+    DeflateChunk(filtered.data(), filtered.size(), &result.deflated);
+  });
+
+  static const uint8_t kSignature[8] = {0x89, 'P',  'N',  'G',
+                                        '\r', '\n', 0x1a, '\n'};
+  out->insert(out->end(), kSignature, kSignature + 8);
+  std::vector<uint8_t> header;
+  PutBigEndian32(&header, uint32_t(width));
+  PutBigEndian32(&header, uint32_t(height));
+  // 8 bits per channel, truecolor, deflate, adaptive filtering, no
+  // interlacing.
+  header.insert(header.end(), {8, 2, 0, 0, 0});
+  PutPngChunk(out, "IHDR", header.data(), header.size());
+
+  // A single IDAT chunk, written in place to avoid another copy.
+  size_t idat_start = out->size();
+  PutBigEndian32(out, 0);
+  out->insert(out->end(), {'I', 'D', 'A', 'T'});
+  // zlib header: deflate with a 32K window, default compression.
+  out->insert(out->end(), {0x78, 0x9c});
+  uint32_t adler = 1;
+  for (const Band& band : results) {
+    out->insert(out->end(), band.deflated.begin(), band.deflated.end());
+    adler = Adler32Combine(adler, band.adler, band.filtered_size);
+  }
+  // Final, empty block with fixed codes.
+  out->insert(out->end(), {0x03, 0x00});
+  PutBigEndian32(out, adler);
+  size_t idat_size = out->size() - idat_start - 8;
+  uint8_t* length = out->data() + idat_start;
+  length[0] = uint8_t(idat_size >> 24);
+  length[1] = uint8_t(idat_size >> 16);
+  length[2] = uint8_t(idat_size >> 8);
+  length[3] = uint8_t(idat_size);
+  PutBigEndian32(out, Crc32(0, out->data() + idat_start + 4, idat_size + 4));
+
+  PutPngChunk(out, "IEND", nullptr, 0);
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Baseline JPEG (ITU T.81) with the example tables from its Annex K.
+
+constexpr uint8_t kZigzag[64] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+
+constexpr uint8_t kLumaQuant[64] = {
+    16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,  58,  60,  55,
+    14, 13, 16, 24, 40,  57,  69,  56,  14, 17, 22, 29, 51,  87,  80,  62,
+    18, 22, 37, 56, 68,  109, 103, 77,  24, 35, 55, 64, 81,  104, 113, 92,
+    49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+
+constexpr uint8_t kChromaQuant[64] = {
+    17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+    24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+    99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+
+constexpr uint8_t kDcLumaBits[16] = {0, 1, 5, 1, 1, 1, 1, 1,
+                                     1, 0, 0, 0, 0, 0, 0, 0};
+constexpr uint8_t kDcChromaBits[16] = {0, 3, 1, 1, 1, 1, 1, 1,
+                                       1, 1, 1, 0, 0, 0, 0, 0};
+constexpr uint8_t kDcValues[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+constexpr uint8_t kAcLumaBits[16] = {0, 2, 1, 3, 3, 2, 4, 3,
+                                     5, 5, 4, 4, 0, 0, 1, 0x7d};
+constexpr uint8_t kAcLumaValues[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06,
+    0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08,
+    0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72,
+    0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45,
+    0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+    0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75,
+    0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3,
+    0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6,
+    0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9,
+    0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4,
+    0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+
+constexpr uint8_t kAcChromaBits[16] = {0, 2, 1, 2, 4, 4, 3, 4,
+                                       7, 5, 4, 4, 0, 1, 2, 0x77};
+constexpr uint8_t kAcChromaValues[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41,
+    0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91,
+    0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1,
+    0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44,
+    0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+    0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74,
+    0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a,
+    0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4,
+    0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+    0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4,
+    0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+
+struct JpegHuffmanTable {
+  uint16_t codes[256] = {};
+  uint8_t sizes[256] = {};
+
+  JpegHuffmanTable(const uint8_t* bits, const uint8_t* values) {
+    int code = 0;
+    int k = 0;
+    for (int length = 1; length <= 16; length++) {
+      for (int i = 0; i < bits[length - 1]; i++, k++) {
+        codes[values[k]] = uint16_t(code++);
+        sizes[values[k]] = uint8_t(length);
+      }
+      code <<= 1;
+    }
+  }
+};
+
+// JPEG packs bits most significant first and stuffs a zero after every
+// 0xff byte of entropy-coded data.
+class JpegBitWriter {
+ public:
+  explicit JpegBitWriter(std::vector<uint8_t>* out) : out_(out) {}
+
+  void Put(uint32_t value, int count) {
+    bits_ = (bits_ << count) | (value & ((1u << count) - 1));
+    count_ += count;
+    while (count_ >= 8) {
+      uint8_t byte = uint8_t(bits_ >> (count_ - 8));
+      out_->push_back(byte);
+      if (byte == 0xff)
+        out_->push_back(0);
+      count_ -= 8;
+    }
+  }
+
+  // Pads the last byte with ones, as the standard asks.
+  void Flush() {
+    if (count_ > 0)
+      Put(0x7f, 8 - count_);
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+  uint64_t bits_ = 0;
+  int count_ = 0;
+};
+
+// AAN floating-point forward DCT, as in libjpeg's jfdctflt.c. The output is
+// scaled by the AAN factors, which the quantization divisors undo.
+void ForwardDct(float* data) {
+  for (int pass = 0; pass < 2; pass++) {
+    // Rows first, then columns.
+    int step = pass == 0 ? 1 : 8;
+    int next = pass == 0 ? 8 : 1;
+    for (int line = 0; line < 8; line++) {
+      float* d = data + line * next;
+      float tmp0 = d[0] + d[7 * step];
+      float tmp7 = d[0] - d[7 * step];
+      float tmp1 = d[step] + d[6 * step];
+      float tmp6 = d[step] - d[6 * step];
+      float tmp2 = d[2 * step] + d[5 * step];
+      float tmp5 = d[2 * step] - d[5 * step];
+      float tmp3 = d[3 * step] + d[4 * step];
+      float tmp4 = d[3 * step] - d[4 * step];
+
+      float tmp10 = tmp0 + tmp3;
+      float tmp13 = tmp0 - tmp3;
+      float tmp11 = tmp1 + tmp2;
+      float tmp12 = tmp1 - tmp2;
+      d[0] = tmp10 + tmp11;
+      d[4 * step] = tmp10 - tmp11;
+      float z1 = (tmp12 + tmp13) * 0.707106781f;
+      d[2 * step] = tmp13 + z1;
+      d[6 * step] = tmp13 - z1;
+
+      tmp10 = tmp4 + tmp5;
+      tmp11 = tmp5 + tmp6;
+      tmp12 = tmp6 + tmp7;
+      float z5 = (tmp10 - tmp12) * 0.382683433f;
+      float z2 = 0.541196100f * tmp10 + z5;
+      float z4 = 1.306562965f * tmp12 + z5;
+      float z3 = tmp11 * 0.707106781f;
+      float z11 = tmp7 + z3;
+      float z13 = tmp7 - z3;
+      d[5 * step] = z13 + z2;
+      d[3 * step] = z13 - z2;
+      d[step] = z11 + z4;
+      d[7 * step] = z11 - z4;
+    }
+  }
+}
+
+class JpegEncoder {
+ public:
+  explicit JpegEncoder(int quality)
+      : dc_luma_(kDcLumaBits, kDcValues),
+        dc_chroma_(kDcChromaBits, kDcValues),
+        ac_luma_(kAcLumaBits, kAcLumaValues),
+        ac_chroma_(kAcChromaBits, kAcChromaValues) {
+    quality = std::min(std::max(quality, 1), 100);
+    // The IJG quality scaling.
+    int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+    static const float kAanScale[8] = {1.0f,         1.387039845f, 1.306562965f,
+                                       1.175875602f, 1.0f,         0.785694958f,
+                                       0.541196100f, 0.275899379f};
+    for (int i = 0; i < 64; i++) {
+      luma_quant_[i] = uint8_t(
+          std::min(std::max((kLumaQuant[i] * scale + 50) / 100, 1), 255));
+      chroma_quant_[i] = uint8_t(
+          std::min(std::max((kChromaQuant[i] * scale + 50) / 100, 1), 255));
+      float aan = kAanScale[i / 8] * kAanScale[i % 8] * 8.0f;
+      luma_divisors_[i] = 1.0f / (luma_quant_[i] * aan);
+      chroma_divisors_[i] = 1.0f / (chroma_quant_[i] * aan);
+    }
+  }
+
+  void Encode(const uint8_t* rgba,
+              int width,
+              int height,
+              int stride,
+              std::vector<uint8_t>* out) {
+    WriteHeaders(width, height, out);
+    JpegBitWriter writer(out);
+    int dc[3] = {};
+    float y_blocks[4][64];
+    float cb_block[64];
+    float cr_block[64];
+    for (int mcu_y = 0; mcu_y < height; mcu_y += 16) {
+      for (int mcu_x = 0; mcu_x < width; mcu_x += 16) {
+        std::fill(cb_block, cb_block + 64, 0.0f);
+        std::fill(cr_block, cr_block + 64, 0.0f);
+        for (int y = 0; y < 16; y++) {
+          // Edge MCUs repeat the last row and column.
+          int sy = std::min(mcu_y + y, height - 1);
+          const uint8_t* row = rgba + size_t(sy) * stride;
+          for (int x = 0; x < 16; x++) {
+            int sx = std::min(mcu_x + x, width - 1);
+            const uint8_t* p = row + sx * 4;
+            float r = p[0];
+            float g = p[1];
+            float b = p[2];
+            int block = (y / 8) * 2 + x / 8;
+            y_blocks[block][(y % 8) * 8 + x % 8] =
+                0.299f * r + 0.587f * g + 0.114f * b - 128.0f;
+            int c = (y / 2) * 8 + x / 2;
+            cb_block[c] += (-0.168736f * r - 0.331264f * g + 0.5f * b) * 0.25f;
+            cr_block[c] += (0.5f * r - 0.418688f * g - 0.081312f * b) * 0.25f;
+          }
+        }
+        for (int block = 0; block < 4; block++) {
+          EncodeBlock(y_blocks[block], luma_divisors_, dc_luma_, ac_luma_,
+                      &dc[0], &writer);
+        }
+        EncodeBlock(cb_block, chroma_divisors_, dc_chroma_, ac_chroma_, &dc[1],
+                    &writer);
+        EncodeBlock(cr_block, chroma_divisors_, dc_chroma_, ac_chroma_, &dc[2],
+                    &writer);
+      }
+    }
+    writer.Flush();
+    out->insert(out->end(), {0xff, 0xd9});
+  }
+
+ private:
+  void WriteHeaders(int width, int height, std::vector<uint8_t>* out) {
+    // SOI and a JFIF APP0 segment.
+    out->insert(out->end(), {0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 'J', 'F', 'I',
+                             'F', 0x00, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00,
+                             0x01, 0x00, 0x00});
+    // DQT: both tables, in zigzag order.
+    out->insert(out->end(), {0xff, 0xdb, 0x00, 0x84, 0x00});
+    for (int i = 0; i < 64; i++)
+      out->push_back(luma_quant_[kZigzag[i]]);
+    out->push_back(0x01);
+    for (int i = 0; i < 64; i++)
+      out->push_back(chroma_quant_[kZigzag[i]]);
+    // SOF0: 8-bit, three components, luma sampled 2x2.
+    out->insert(out->end(), {0xff, 0xc0, 0x00, 0x11, 0x08});
+    PutBigEndian16(out, uint32_t(height));
+    PutBigEndian16(out, uint32_t(width));
+    out->insert(out->end(), {0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03,
+                             0x11, 0x01});
+    WriteHuffmanTable(0x00, kDcLumaBits, kDcValues, 12, out);
+    WriteHuffmanTable(0x10, kAcLumaBits, kAcLumaValues, 162, out);
+    WriteHuffmanTable(0x01, kDcChromaBits, kDcValues, 12, out);
+    WriteHuffmanTable(0x11, kAcChromaBits, kAcChromaValues, 162, out);
+    // SOS: all three components, full spectral range.
+    out->insert(out->end(), {0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02,
+                             0x11, 0x03, 0x11, 0x00, 0x3f, 0x00});
+  }
+
+  static void WriteHuffmanTable(uint8_t id,
+                                const uint8_t* bits,
+                                const uint8_t* values,
+                                int count,
+                                std::vector<uint8_t>* out) {
+    out->insert(out->end(), {0xff, 0xc4});
+    PutBigEndian16(out, uint32_t(3 + 16 + count));
+    out->push_back(id);
+    out->insert(out->end(), bits, bits + 16);
+    out->insert(out->end(), values, values + count);
+  }
+
+  static int BitLength(int value) {
+    int bits = 0;
+    for (value = std::abs(value); value; value >>= 1)
+      bits++;
+    return bits;
+  }
+
+  // Negative values are sent as the low bits of value - 1.
+  static void PutValue(int value, int bits, JpegBitWriter* writer) {
+    if (bits > 0)
+      writer->Put(uint32_t(value < 0 ? value - 1 : value), bits);
+  }
+
+  void EncodeBlock(float* block,
+                   const float* divisors,
+                   const JpegHuffmanTable& dc_table,
+                   const JpegHuffmanTable& ac_table,
+                   int* previous_dc,
+                   JpegBitWriter* writer) {
+    ForwardDct(block);
+    int coefficients[64];
+    for (int i = 0; i < 64; i++) {
+      int natural = kZigzag[i];
+      coefficients[i] = int(std::lround(block[natural] * divisors[natural]));
+    }
+
+    int diff = coefficients[0] - *previous_dc;
+    *previous_dc = coefficients[0];
+    int bits = BitLength(diff);
+    writer->Put(dc_table.codes[bits], dc_table.sizes[bits]);
+    PutValue(diff, bits, writer);
+
+    int zeros = 0;
+    for (int i = 1; i < 64; i++) {
+      int value = coefficients[i];
+      if (value == 0) {
+        zeros++;
+        continue;
+      }
+      // Runs longer than 15 zeros are sent as ZRL symbols.
+      for (; zeros >= 16; zeros -= 16)
+        writer->Put(ac_table.codes[0xf0], ac_table.sizes[0xf0]);
+      bits = BitLength(value);
+      int symbol = (zeros << 4) | bits;
+      writer->Put(ac_table.codes[symbol], ac_table.sizes[symbol]);
+      PutValue(value, bits, writer);
+      zeros = 0;
+    }
+    if (zeros > 0)
+      writer->Put(ac_table.codes[0x00], ac_table.sizes[0x00]);
+  }
+
+  JpegHuffmanTable dc_luma_;
+  JpegHuffmanTable dc_chroma_;
+  JpegHuffmanTable ac_luma_;
+  JpegHuffmanTable ac_chroma_;
+  uint8_t luma_quant_[64];
+  uint8_t chroma_quant_[64];
+  float luma_divisors_[64];
+  float chroma_divisors_[64];
+};
+
+}  // namespace
+
+bool ImageFormatFromName(const std::string& name, ImageFormat* format) {
+  if (name == "png") {
+    *format = ImageFormat::kPng;
+    return true;
+  }
+  if (name == "jpeg" || name == "jpg") {
+    *format = ImageFormat::kJpeg;
+    return true;
+  }
+  return false;
+}
+
+bool EncodeImage(const uint8_t* rgba,
+                 int width,
+                 int height,
+                 int stride,
+                 const ImageEncodeOptions& options,
+                 std::vector<uint8_t>* out) {
+  out->clear();
+  if (rgba == nullptr || width <= 0 || height <= 0)
+    return false;
+  if (stride <= 0)
+    stride = width * 4;
+  if (options.format == ImageFormat::kJpeg) {
+    // Baseline JPEG stores dimensions in 16 bits.
+    if (width > 0xffff || height > 0xffff)
+      return false;
+    JpegEncoder(options.quality).Encode(rgba, width, height, stride, out);
+    return true;
+  }
+  return EncodePng(rgba, width, height, stride, out);
+}
+
+}  // namespace flutter_webrtc_plugin
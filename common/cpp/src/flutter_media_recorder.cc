@@ -0,0 +1,258 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "flutter_media_recorder.h"
+
+#include <string.h>
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+const char kFrameTag[] = "FRAME\n";
+constexpr size_t kFrameTagSize = sizeof(kFrameTag) - 1;
+
+// Small frames are coalesced into writes of this size; large ones bypass
+// the buffer and go to the file in one call each.
+constexpr size_t kWriteBufferBytes = 1024 * 1024;
+
+// Written frame buffers kept for reuse by the decode thread.
+constexpr size_t kMaxFreeBuffers = 4;
+
+void CopyPlane(const uint8_t* src,
+               int src_stride,
+               int width,
+               int height,
+               uint8_t* dst) {
+  for (int y = 0; y < height; y++) {
+    memcpy(dst, src, width);
+    src += src_stride;
+    dst += width;
+  }
+}
+
+}  // namespace
+
+FlutterMediaRecorder::FlutterMediaRecorder(scoped_refptr<RTCVideoTrack> track,
+                                           const std::string& path,
+                                           size_t max_queued_bytes)
+    : track_(track), path_(path), max_queued_bytes_(max_queued_bytes) {}
+
+FlutterMediaRecorder::~FlutterMediaRecorder() {
+  // The writer holds a reference while it runs, so it is either joined
+  // already or is the thread dropping the last reference on its way out.
+  if (writer_.joinable())
+    writer_.detach();
+  if (file_)
+    fclose(file_);
+}
+
+bool FlutterMediaRecorder::Start(std::string* error) {
+  file_ = fopen(path_.c_str(), "wb");
+  if (!file_) {
+    *error = "Cannot open " + path_ + " for writing";
+    return false;
+  }
+  setvbuf(file_, nullptr, _IOFBF, kWriteBufferBytes);
+  // The writer owns a reference so the recorder outlives the drain even
+  // after the manager has let go of it.
+  std::shared_ptr<FlutterMediaRecorder> self = shared_from_this();
+  writer_ = std::thread([self] { self->WriterLoop(); });
+  track_->AddRenderer(this);
+  return true;
+}
+
+void FlutterMediaRecorder::Stop(std::unique_ptr<MethodResultProxy> result) {
+  stop_result_ = std::move(result);
+  track_->RemoveRenderer(this);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_one();
+}
+
+std::vector<uint8_t> FlutterMediaRecorder::TakeBuffer() {
+  if (free_buffers_.empty())
+    return std::vector<uint8_t>();
+  std::vector<uint8_t> buffer = std::move(free_buffers_.back());
+  free_buffers_.pop_back();
+  return buffer;
+}
+
+void FlutterMediaRecorder::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
+  if (write_failed_) {
+    frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  int frame_width = frame->width();
+  int frame_height = frame->height();
+  int width = 0;
+  int height = 0;
+
+  std::string header;
+  std::vector<uint8_t> buffer;
+  size_t luma_size = 0;
+  size_t chroma_size = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_)
+      return;
+    if (width_ == 0) {
+      width_ = frame_width;
+      height_ = frame_height;
+      // The rate is nominal: frames are written as they arrive.
+      header = "YUV4MPEG2 W" + std::to_string(width_) + " H" +
+               std::to_string(height_) + " F30:1 Ip A1:1 C420jpeg\n";
+    }
+    width = width_;
+    height = height_;
+    luma_size = size_t(width) * height;
+    chroma_size = size_t((width + 1) / 2) * ((height + 1) / 2);
+    size_t size = header.size() + kFrameTagSize + luma_size + chroma_size * 2;
+    // Always admit one frame so a tiny budget cannot stall the recording.
+    if (!queue_.empty() && queued_bytes_ + size > max_queued_bytes_) {
+      frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    queued_bytes_ += size;
+    buffer = TakeBuffer();
+    buffer.resize(size);
+  }
+
+  // Copy outside the lock so the writer is never held up by it.
+  uint8_t* dst = buffer.data();
+  memcpy(dst, header.data(), header.size());
+  dst += header.size();
+  memcpy(dst, kFrameTag, kFrameTagSize);
+  dst += kFrameTagSize;
+  int chroma_width = (width + 1) / 2;
+  int chroma_height = (height + 1) / 2;
+  uint8_t* dst_u = dst + luma_size;
+  uint8_t* dst_v = dst_u + chroma_size;
+  if (frame_width == width && frame_height == height) {
+    CopyPlane(frame->DataY(), frame->StrideY(), width, height, dst);
+    CopyPlane(frame->DataU(), frame->StrideU(), chroma_width, chroma_height,
+              dst_u);
+    CopyPlane(frame->DataV(), frame->StrideV(), chroma_width, chroma_height,
+              dst_v);
+  } else {
+    // Y4M cannot change size mid-stream, and remote tracks change
+    // resolution as bandwidth varies, so keep recording at the first size.
+    ScaleI420(I420PlanesFromFrame(*frame), width, height, dst, width, dst_u,
+              chroma_width, dst_v, chroma_width, &scale_scratch_);
+    frames_resized_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(buffer));
+  }
+  cv_.notify_one();
+}
+
+void FlutterMediaRecorder::WriterLoop() {
+  std::deque<std::vector<uint8_t>> batch;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty())
+        break;
+      batch.swap(queue_);
+    }
+
+    size_t batch_bytes = 0;
+    for (const std::vector<uint8_t>& buffer : batch) {
+      batch_bytes += buffer.size();
+      if (write_failed_)
+        continue;
+      if (fwrite(buffer.data(), 1, buffer.size(), file_) != buffer.size()) {
+        write_failed_ = true;
+        continue;
+      }
+      frames_written_.fetch_add(1, std::memory_order_relaxed);
+      bytes_written_.fetch_add(buffer.size(), std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_bytes_ -= batch_bytes;
+    while (!batch.empty()) {
+      if (free_buffers_.size() < kMaxFreeBuffers)
+        free_buffers_.push_back(std::move(batch.front()));
+      batch.pop_front();
+    }
+  }
+
+  if (fclose(file_) != 0)
+    write_failed_ = true;
+  file_ = nullptr;
+
+  // Hand completion to the platform thread, which joins this thread.
+  std::shared_ptr<FlutterMediaRecorder> self = shared_from_this();
+  TaskRunner::Platform()->EnqueueTask([self] { self->Complete(); });
+}
+
+void FlutterMediaRecorder::Complete() {
+  writer_.join();
+  if (!stop_result_)
+    return;
+  if (write_failed_) {
+    stop_result_->Error("stopRecordToFile", "Failed writing to " + path_);
+    return;
+  }
+  EncodableMap stats;
+  auto count = [&](const char* key, uint64_t value) {
+    stats[EncodableValue(key)] = EncodableValue(static_cast<int64_t>(value));
+  };
+  count("framesWritten", frames_written_);
+  count("framesDropped", frames_dropped_);
+  count("framesResized", frames_resized_);
+  count("bytesWritten", bytes_written_);
+  stop_result_->Success(EncodableValue(stats));
+}
+
+FlutterMediaRecorderManager::FlutterMediaRecorderManager(
+    FlutterWebRTCBase* base)
+    : base_(base) {}
+
+FlutterMediaRecorderManager::~FlutterMediaRecorderManager() {
+  for (auto& it : recorders_) {
+    it.second->Stop(nullptr);
+  }
+}
+
+void FlutterMediaRecorderManager::StartRecordToFile(
+    const std::string& path,
+    int64_t recorder_id,
+    RTCVideoTrack* track,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (recorders_.find(recorder_id) != recorders_.end()) {
+    result->Error("startRecordToFile", "Recorder is already started");
+    return;
+  }
+  auto recorder = std::make_shared<FlutterMediaRecorder>(track, path);
+  std::string error;
+  if (!recorder->Start(&error)) {
+    result->Error("startRecordToFile", error);
+    return;
+  }
+  recorders_[recorder_id] = recorder;
+  result->Success();
+}
+
+void FlutterMediaRecorderManager::StopRecordToFile(
+    int64_t recorder_id,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = recorders_.find(recorder_id);
+  if (it == recorders_.end()) {
+    result->Error("stopRecordToFile", "Recorder not found");
+    return;
+  }
+  // The recorder keeps itself alive until its writer has finished.
+  it->second->Stop(std::move(result));
+  recorders_.erase(it);
+}
+
+}  // namespace flutter_webrtc_plugin
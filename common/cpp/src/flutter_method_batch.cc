@@ -0,0 +1,120 @@
+#include "flutter_method_batch.h"
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+// Collects the reply of one batched operation.
+class BatchOperationResult : public MethodResultProxy {
+ public:
+  BatchOperationResult(std::shared_ptr<MethodBatch> batch,
+                       const std::string& method_name)
+      : batch_(std::move(batch)), method_name_(method_name) {}
+
+  ~BatchOperationResult() {
+    // Handlers that drop their result without replying must not stall the
+    // rest of the batch.
+    if (!replied_)
+      Error("NoReply", method_name_ + "() did not reply");
+  }
+
+  void Success() override { Success(EncodableValue()); }
+
+  void Success(const EncodableValue& result) override {
+    EncodableMap outcome = Outcome(true);
+    outcome[EncodableValue("result")] = result;
+    Complete(std::move(outcome), false);
+  }
+
+  void Error(const std::string& error_code,
+             const std::string& error_message,
+             const EncodableValue& error_details) override {
+    EncodableMap outcome = Outcome(false);
+    outcome[EncodableValue("code")] = EncodableValue(error_code);
+    outcome[EncodableValue("message")] = EncodableValue(error_message);
+    outcome[EncodableValue("details")] = error_details;
+    Complete(std::move(outcome), true);
+  }
+
+  void Error(const std::string& error_code,
+             const std::string& error_message = "") override {
+    Error(error_code, error_message, EncodableValue());
+  }
+
+  void NotImplemented() override {
+    Error("NotImplemented", method_name_ + "() is not implemented");
+  }
+
+ private:
+  EncodableMap Outcome(bool success) {
+    EncodableMap outcome;
+    outcome[EncodableValue("method")] = EncodableValue(method_name_);
+    outcome[EncodableValue("success")] = EncodableValue(success);
+    return outcome;
+  }
+
+  void Complete(EncodableMap outcome, bool failed) {
+    if (replied_)
+      return;
+    replied_ = true;
+    batch_->OnOperationComplete(std::move(outcome), failed);
+  }
+
+  std::shared_ptr<MethodBatch> batch_;
+  std::string method_name_;
+  bool replied_ = false;
+};
+
+}  // namespace
+
+void MethodBatch::Run() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopped_ || next_ >= operations_.size()) {
+      lock.unlock();
+      result_->Success(EncodableValue(std::move(results_)));
+      return;
+    }
+    const EncodableValue& operation = operations_[next_++];
+    current_completed_ = false;
+    lock.unlock();
+
+    const ArgView op(&operation);
+    const std::string& method_name = op.String("method");
+    auto op_result =
+        std::make_unique<BatchOperationResult>(shared_from_this(), method_name);
+    if (method_name.empty() || method_name == "executeBatch") {
+      op_result->Error("Bad Arguments",
+                       "executeBatch() operation needs a method name");
+    } else {
+      const EncodableValue& args = op.Value("args");
+      dispatcher_(method_name, args.IsNull() ? nullptr : &args,
+                  std::move(op_result));
+    }
+
+    lock.lock();
+    if (!current_completed_) {
+      // The handler replies later; OnOperationComplete resumes the batch.
+      waiting_for_async_ = true;
+      return;
+    }
+  }
+}
+
+void MethodBatch::OnOperationComplete(EncodableMap outcome, bool failed) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  results_.push_back(EncodableValue(std::move(outcome)));
+  if (failed && stop_on_error_)
+    stopped_ = true;
+  current_completed_ = true;
+  if (waiting_for_async_) {
+    waiting_for_async_ = false;
+    lock.unlock();
+    // Async replies may come from libwebrtc's threads; the remaining
+    // handlers must run on the platform thread.
+    std::shared_ptr<MethodBatch> self = shared_from_this();
+    TaskRunner::Platform()->EnqueueTask([self] { self->Run(); });
+  }
+}
+
+}  // namespace flutter_webrtc_plugin
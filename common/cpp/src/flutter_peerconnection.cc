@@ -336,9 +336,22 @@ void FlutterPeerConnection::CreateRTCPeerConnection(
 
   std::string event_channel = "FlutterWebRTC/peerConnectionEvent" + uuid;
 
+  // Opt-in: hold local candidates back and send them in batches.
+  int candidate_batch_window_ms =
+      findInt(configurationMap, "iceCandidateBatchWindowMs");
+  std::chrono::milliseconds candidate_batch_window(
+      candidate_batch_window_ms > 0 ? candidate_batch_window_ms : 0);
+
+  // Opt-in: send this connection's and its data channels' events in
+  // batches. The Dart listeners accept both shapes.
+  EventQueueOptions event_options;
+  if (findBoolean(configurationMap, "batchEvents"))
+    event_options = EventQueueOptions::Batched();
+
   std::unique_ptr<FlutterPeerConnectionObserver> observer(
-      new FlutterPeerConnectionObserver(base_, pc, base_->messenger_,
-                                        event_channel, uuid));
+      new FlutterPeerConnectionObserver(
+          base_, pc, base_->messenger_, event_channel, uuid,
+          candidate_batch_window, event_options));
 
   base_->peerconnection_observers_[uuid] = std::move(observer);
 
@@ -687,60 +700,60 @@ void FlutterPeerConnection::RtpSenderReplaceTrack(
 }
 
 scoped_refptr<RTCRtpParameters> FlutterPeerConnection::updateRtpParameters(
-    EncodableMap newParameters,
+    const EncodableMap& newParameters,
     scoped_refptr<RTCRtpParameters> parameters) {
-  EncodableList encodings = findList(newParameters, "encodings");
-  auto encoding = encodings.begin();
+  const EncodableList* encodings = findListRef(newParameters, "encodings");
+  size_t index = 0;
   auto params = parameters->encodings();
   for (auto param : params.std_vector()) {
-    if (encoding != encodings.end()) {
-      EncodableMap map = GetValue<EncodableMap>(*encoding);
-      EncodableValue value = findEncodableValue(map, "active");
-      if (!value.IsNull()) {
-        param->set_active(GetValue<bool>(value));
+    if (encodings != nullptr && index < encodings->size()) {
+      const EncodableMap& map = GetValue<EncodableMap>((*encodings)[index]);
+      const EncodableValue* value = findValueRef(map, "active");
+      if (value && !value->IsNull()) {
+        param->set_active(GetValue<bool>(*value));
       }
-      value = findEncodableValue(map, "rid");
-      if (!value.IsNull()) {
-        param->set_rid(GetValue<std::string>(value));
+      value = findValueRef(map, "rid");
+      if (value && !value->IsNull()) {
+        param->set_rid(GetValue<std::string>(*value));
       }
-      value = findEncodableValue(map, "ssrc");
-      if (!value.IsNull()) {
-        param->set_ssrc(GetValue<int>(value));
+      value = findValueRef(map, "ssrc");
+      if (value && !value->IsNull()) {
+        param->set_ssrc(GetValue<int>(*value));
       }
-      value = findEncodableValue(map, "maxBitrate");
-      if (!value.IsNull()) {
-        param->set_max_bitrate_bps(GetValue<int>(value));
+      value = findValueRef(map, "maxBitrate");
+      if (value && !value->IsNull()) {
+        param->set_max_bitrate_bps(GetValue<int>(*value));
       }
 
-      value = findEncodableValue(map, "minBitrate");
-      if (!value.IsNull()) {
-        param->set_min_bitrate_bps(GetValue<int>(value));
+      value = findValueRef(map, "minBitrate");
+      if (value && !value->IsNull()) {
+        param->set_min_bitrate_bps(GetValue<int>(*value));
       }
 
-      value = findEncodableValue(map, "maxFramerate");
-      if (!value.IsNull()) {
-        param->set_max_framerate(GetValue<int>(value));
+      value = findValueRef(map, "maxFramerate");
+      if (value && !value->IsNull()) {
+        param->set_max_framerate(GetValue<int>(*value));
       }
-      value = findEncodableValue(map, "numTemporalLayers");
-      if (!value.IsNull()) {
-        param->set_num_temporal_layers(GetValue<int>(value));
+      value = findValueRef(map, "numTemporalLayers");
+      if (value && !value->IsNull()) {
+        param->set_num_temporal_layers(GetValue<int>(*value));
       }
-      value = findEncodableValue(map, "scaleResolutionDownBy");
-      if (!value.IsNull()) {
-        param->set_scale_resolution_down_by(GetValue<double>(value));
+      value = findValueRef(map, "scaleResolutionDownBy");
+      if (value && !value->IsNull()) {
+        param->set_scale_resolution_down_by(GetValue<double>(*value));
       }
-      value = findEncodableValue(map, "scalabilityMode");
-      if (!value.IsNull()) {
-        param->set_scalability_mode(GetValue<std::string>(value));
+      value = findValueRef(map, "scalabilityMode");
+      if (value && !value->IsNull()) {
+        param->set_scalability_mode(GetValue<std::string>(*value));
       }
-      encoding++;
+      index++;
     }
   }
 
-  EncodableValue value =
-      findEncodableValue(newParameters, "degradationPreference");
-  if (!value.IsNull()) {
-    const std::string degradationPreference = GetValue<std::string>(value);
+  const EncodableValue* value =
+      findValueRef(newParameters, "degradationPreference");
+  if (value && !value->IsNull()) {
+    const std::string& degradationPreference = GetValue<std::string>(*value);
     if (degradationPreference == "maintain-framerate") {
       parameters->SetDegradationPreference(
           libwebrtc::RTCDegradationPreference::MAINTAIN_FRAMERATE);
@@ -827,10 +840,9 @@ void FlutterPeerConnection::SetConfiguration(
 
 void FlutterPeerConnection::CaptureFrame(
     RTCVideoTrack* track,
-    std::string path,
+    const FrameCaptureOptions& options,
     std::unique_ptr<MethodResultProxy> result) {
-  FlutterFrameCapturer capturer(track, path);
-  capturer.CaptureFrame(std::move(result));
+  FlutterFrameCapturer::Capture(track, options, std::move(result));
 }
 
 scoped_refptr<RTCRtpTransceiver> FlutterPeerConnection::getRtpTransceiverById(
@@ -925,6 +937,45 @@ void FlutterPeerConnection::AddIceCandidate(
   result->Success();
 }
 
+void FlutterPeerConnection::AddIceCandidates(
+    const EncodableList& candidates,
+    RTCPeerConnection* pc,
+    std::unique_ptr<MethodResultProxy> result) {
+  EncodableList results;
+  results.reserve(candidates.size());
+  for (const EncodableValue& entry : candidates) {
+    EncodableMap outcome;
+    std::string error;
+    const EncodableMap* map = std::get_if<EncodableMap>(&entry);
+    const std::string* candidate =
+        map ? findStringRef(*map, "candidate") : nullptr;
+    if (map == nullptr) {
+      error = "Candidate is not a map";
+    } else if (candidate == nullptr || candidate->empty()) {
+      // End-of-candidates, accepted as addCandidate does.
+    } else {
+      const std::string* sdp_mid = findStringRef(*map, "sdpMid");
+      int sdp_mline_index = findInt(*map, "sdpMLineIndex");
+      SdpParseError parse_error;
+      scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
+          candidate->c_str(), sdp_mid ? sdp_mid->c_str() : "",
+          sdp_mline_index == -1 ? 0 : sdp_mline_index, &parse_error);
+      if (rtc_candidate.get() != nullptr) {
+        pc->AddCandidate(rtc_candidate->sdp_mid(),
+                         rtc_candidate->sdp_mline_index(),
+                         rtc_candidate->candidate());
+      } else {
+        error = "Invalid candidate: " + parse_error.description.std_string();
+      }
+    }
+    outcome[EncodableValue("success")] = EncodableValue(error.empty());
+    if (!error.empty())
+      outcome[EncodableValue("error")] = EncodableValue(error);
+    results.push_back(EncodableValue(std::move(outcome)));
+  }
+  result->Success(EncodableValue(std::move(results)));
+}
+
 EncodableMap statsToMap(const scoped_refptr<MediaRTCStats>& stats) {
   EncodableMap report_map;
   report_map[EncodableValue("id")] = EncodableValue(stats->id().std_string());
@@ -1122,11 +1173,16 @@ FlutterPeerConnectionObserver::FlutterPeerConnectionObserver(
     scoped_refptr<RTCPeerConnection> peerconnection,
     BinaryMessenger* messenger,
     const std::string& channel_name,
-    std::string& peerConnectionId)
-    : event_channel_(EventChannelProxy::Create(messenger, channel_name)),
+    std::string& peerConnectionId,
+    std::chrono::milliseconds candidate_batch_window,
+    const EventQueueOptions& event_options)
+    : event_options_(event_options),
+      event_channel_(
+          EventChannelProxy::Create(messenger, channel_name, event_options)),
       peerconnection_(peerconnection),
       base_(base),
-      id_(peerConnectionId) {
+      id_(peerConnectionId),
+      candidate_batch_window_(candidate_batch_window) {
   peerconnection->RegisterRTCPeerConnectionObserver(this);
 }
 
@@ -1149,6 +1205,9 @@ void FlutterPeerConnectionObserver::OnPeerConnectionState(
 
 void FlutterPeerConnectionObserver::OnIceGatheringState(
     RTCIceGatheringState state) {
+  // Held-back candidates must reach Dart before gathering is reported done.
+  if (state == RTCIceGatheringStateComplete)
+    FlushCandidates();
   EncodableMap params;
   params[EncodableValue("event")] = "iceGatheringState";
   params[EncodableValue("state")] = iceGatheringStateString(state);
@@ -1165,8 +1224,6 @@ void FlutterPeerConnectionObserver::OnIceConnectionState(
 
 void FlutterPeerConnectionObserver::OnIceCandidate(
     scoped_refptr<RTCIceCandidate> candidate) {
-  EncodableMap params;
-  params[EncodableValue("event")] = "onCandidate";
   EncodableMap cand;
   cand[EncodableValue("candidate")] =
       EncodableValue(candidate->candidate().std_string());
@@ -1174,10 +1231,43 @@ void FlutterPeerConnectionObserver::OnIceCandidate(
       EncodableValue(candidate->sdp_mline_index());
   cand[EncodableValue("sdpMid")] =
       EncodableValue(candidate->sdp_mid().std_string());
+  if (candidate_batch_window_.count() > 0) {
+    std::lock_guard<std::mutex> lock(candidates_mutex_);
+    pending_candidates_.push_back(EncodableValue(cand));
+    // The first candidate of a batch schedules its flush.
+    if (pending_candidates_.size() == 1) {
+      std::weak_ptr<int> alive = alive_;
+      TaskRunner::Platform()->EnqueueDelayedTask(
+          [this, alive] {
+            // The observer is destroyed on the platform thread too, so this
+            // check cannot race with its destructor.
+            if (alive.lock())
+              FlushCandidates();
+          },
+          candidate_batch_window_);
+    }
+    return;
+  }
+  EncodableMap params;
+  params[EncodableValue("event")] = "onCandidate";
   params[EncodableValue("candidate")] = EncodableValue(cand);
   event_channel_->Success(EncodableValue(params));
 }
 
+void FlutterPeerConnectionObserver::FlushCandidates() {
+  std::lock_guard<std::mutex> lock(candidates_mutex_);
+  if (pending_candidates_.empty())
+    return;
+  EncodableMap params;
+  params[EncodableValue("event")] = "onCandidates";
+  params[EncodableValue("candidates")] =
+      EncodableValue(std::move(pending_candidates_));
+  pending_candidates_ = EncodableList();
+  // Sent under the lock so batches flushed from the signaling thread and
+  // from the timer keep their order.
+  event_channel_->Success(EncodableValue(params));
+}
+
 void FlutterPeerConnectionObserver::OnAddStream(
     scoped_refptr<RTCMediaStream> stream) {
   std::string streamId = stream->id().std_string();
@@ -1329,7 +1419,7 @@ void FlutterPeerConnectionObserver::OnDataChannel(
 
   std::unique_ptr<FlutterRTCDataChannelObserver> observer(
       new FlutterRTCDataChannelObserver(data_channel, base_->messenger_,
-                                        event_channel));
+                                        event_channel, event_options_));
 
   base_->lock();
   base_->data_channel_observers_[channel_uuid] = std::move(observer);
@@ -0,0 +1,78 @@
+#include "flutter_pixel_buffer_pool.h"
+
+namespace flutter_webrtc_plugin {
+
+void PixelBufferPool::Buffer::Release() {
+  if (pool_ && data_) {
+    pool_->Return(std::move(data_), size_);
+  }
+  pool_.reset();
+  data_.reset();
+  size_ = 0;
+}
+
+std::shared_ptr<PixelBufferPool> PixelBufferPool::Create(
+    size_t high_water_bytes) {
+  // Uses new instead of make_shared due to private constructor.
+  return std::shared_ptr<PixelBufferPool>(
+      new PixelBufferPool(high_water_bytes));
+}
+
+size_t PixelBufferPool::SizeClass(size_t size) {
+  constexpr size_t kMinClass = 64 * 1024;
+  if (size <= kMinClass)
+    return kMinClass;
+  size_t power = kMinClass;
+  while (power < size)
+    power <<= 1;
+  size_t midpoint = power - power / 4;
+  return size <= midpoint ? midpoint : power;
+}
+
+PixelBufferPool::Buffer PixelBufferPool::Acquire(size_t size) {
+  size_t size_class = SizeClass(size);
+  std::unique_ptr<uint8_t[]> data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(size_class);
+    if (it != idle_.end() && !it->second.empty()) {
+      data = std::move(it->second.back());
+      it->second.pop_back();
+      stats_.bytes_idle -= size_class;
+      stats_.hits++;
+    } else {
+      stats_.misses++;
+    }
+    stats_.bytes_in_use += size_class;
+  }
+  if (!data)
+    data.reset(new uint8_t[size_class]);
+  return Buffer(shared_from_this(), std::move(data), size_class);
+}
+
+void PixelBufferPool::Return(std::unique_ptr<uint8_t[]> data, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.bytes_in_use -= size;
+  if (stats_.bytes_idle + size > high_water_bytes_)
+    return;
+  idle_[size].push_back(std::move(data));
+  stats_.bytes_idle += size;
+}
+
+void PixelBufferPool::Trim(size_t max_idle_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = idle_.rbegin();
+       it != idle_.rend() && stats_.bytes_idle > max_idle_bytes; ++it) {
+    while (!it->second.empty() && stats_.bytes_idle > max_idle_bytes) {
+      it->second.pop_back();
+      stats_.bytes_idle -= it->first;
+    }
+  }
+}
+
+PixelBufferPool::Stats PixelBufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace flutter_webrtc_plugin
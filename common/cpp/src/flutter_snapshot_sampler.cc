@@ -0,0 +1,284 @@
+#ifdef _MSC_VER
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "flutter_snapshot_sampler.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter_worker_pool.h"
+#include "flutter_yuv_converter.h"
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+// Track ids come from the remote side; keep only characters that are safe
+// in a file name everywhere.
+std::string FileNameForTrack(const std::string& track_id) {
+  std::string name = track_id;
+  for (char& c : name) {
+    bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') || c == '-' || c == '_';
+    if (!safe)
+      c = '_';
+  }
+  return name;
+}
+
+}  // namespace
+
+void FlutterSnapshotSampler::TrackSink::OnFrame(
+    scoped_refptr<RTCVideoFrame> frame) {
+  if (!armed_.load(std::memory_order_relaxed) || !armed_.exchange(false))
+    return;
+  std::weak_ptr<FlutterSnapshotSampler> sampler = sampler_;
+  uint64_t sink_id = id_;
+  TaskRunner::Platform()->EnqueueTask([sampler, sink_id, frame] {
+    if (auto self = sampler.lock())
+      self->OnSample(sink_id, frame);
+  });
+}
+
+FlutterSnapshotSampler::FlutterSnapshotSampler(
+    FlutterVideoRendererManager* manager,
+    EventChannelProxy* event_channel,
+    const Options& options)
+    : manager_(manager), event_channel_(event_channel), options_(options) {}
+
+FlutterSnapshotSampler::~FlutterSnapshotSampler() {
+  Stop();
+}
+
+void FlutterSnapshotSampler::Start() {
+  stopped_ = false;
+  ScheduleTick();
+}
+
+void FlutterSnapshotSampler::ScheduleTick() {
+  std::weak_ptr<FlutterSnapshotSampler> weak_self = shared_from_this();
+  TaskRunner::Platform()->EnqueueDelayedTask(
+      [weak_self] {
+        if (auto self = weak_self.lock())
+          self->Tick();
+      },
+      options_.interval);
+}
+
+void FlutterSnapshotSampler::SetTracks(
+    const std::vector<std::pair<std::string, scoped_refptr<RTCVideoTrack>>>&
+        tracks) {
+  std::vector<std::unique_ptr<TrackSink>> sinks;
+  for (const auto& entry : tracks) {
+    if (!entry.second)
+      continue;
+    auto existing = std::find_if(
+        sinks_.begin(), sinks_.end(), [&](const std::unique_ptr<TrackSink>& s) {
+          return s && s->track_id_ == entry.first &&
+                 s->track_.get() == entry.second.get();
+        });
+    if (existing != sinks_.end()) {
+      sinks.push_back(std::move(*existing));
+      continue;
+    }
+    auto sink = std::make_unique<TrackSink>(
+        weak_from_this(), next_sink_id_++, entry.first, entry.second);
+    manager_->AttachToTrack(sink->track_, sink.get());
+    sinks.push_back(std::move(sink));
+  }
+  for (auto& sink : sinks_) {
+    if (!sink)
+      continue;
+    manager_->DetachFromTrack(sink->track_, sink.get());
+    // A dropped sink still armed will never sample; one that already fired
+    // is accounted for when its sample arrives.
+    if (sink->armed_.exchange(false) && awaiting_samples_ > 0)
+      awaiting_samples_--;
+  }
+  sinks_ = std::move(sinks);
+  // Samples of tracks no longer subscribed are not worth encoding.
+  pending_.erase(
+      std::remove_if(pending_.begin(), pending_.end(),
+                     [this](const Job& job) {
+                       return std::none_of(
+                           sinks_.begin(), sinks_.end(),
+                           [&](const std::unique_ptr<TrackSink>& sink) {
+                             return sink->track_id_ == job.track_id;
+                           });
+                     }),
+      pending_.end());
+  // The dropped tracks may have been all the round was waiting for.
+  if (in_flight_ == 0 && pending_.empty() && awaiting_samples_ == 0)
+    FlushBatch();
+}
+
+void FlutterSnapshotSampler::Stop() {
+  stopped_ = true;
+  for (auto& sink : sinks_) {
+    manager_->DetachFromTrack(sink->track_, sink.get());
+  }
+  sinks_.clear();
+  pending_.clear();
+  batch_.clear();
+}
+
+void FlutterSnapshotSampler::Tick() {
+  if (stopped_)
+    return;
+  // Tracks that delivered nothing last round do not hold up its event.
+  if (in_flight_ == 0 && pending_.empty())
+    FlushBatch();
+  awaiting_samples_ = sinks_.size();
+  for (auto& sink : sinks_) {
+    sink->armed_ = true;
+  }
+  ScheduleTick();
+}
+
+void FlutterSnapshotSampler::OnSample(uint64_t sink_id,
+                                      scoped_refptr<RTCVideoFrame> frame) {
+  if (stopped_)
+    return;
+  auto sink = std::find_if(
+      sinks_.begin(), sinks_.end(),
+      [&](const std::unique_ptr<TrackSink>& s) { return s->id_ == sink_id; });
+  if (awaiting_samples_ > 0)
+    awaiting_samples_--;
+  if (sink == sinks_.end()) {
+    // Sampled just before SetTracks dropped its track.
+    if (in_flight_ == 0 && pending_.empty() && awaiting_samples_ == 0)
+      FlushBatch();
+    return;
+  }
+  const std::string& track_id = (*sink)->track_id_;
+  auto queued =
+      std::find_if(pending_.begin(), pending_.end(),
+                   [&](const Job& job) { return job.track_id == track_id; });
+  if (queued != pending_.end()) {
+    // The previous sample never got an encoder; the newer one wins.
+    queued->frame = frame;
+    skipped_++;
+  } else {
+    pending_.push_back({track_id, frame, (*sink)->samples_++});
+  }
+  Dispatch();
+}
+
+void FlutterSnapshotSampler::Dispatch() {
+  std::shared_ptr<FlutterSnapshotSampler> self = shared_from_this();
+  while (in_flight_ < options_.max_concurrent_encodes && !pending_.empty()) {
+    Job job = std::move(pending_.front());
+    pending_.pop_front();
+    std::shared_ptr<Workspace> workspace;
+    if (!idle_workspaces_.empty()) {
+      workspace = std::move(idle_workspaces_.back());
+      idle_workspaces_.pop_back();
+    } else {
+      workspace = std::make_shared<Workspace>();
+    }
+    in_flight_++;
+    WorkerPool::Shared()->Post([self, job, workspace] {
+      auto snapshot = std::make_shared<EncodableValue>(
+          self->Process(job, workspace.get()));
+      TaskRunner::Platform()->EnqueueTask([self, snapshot, workspace] {
+        self->OnProcessed(std::move(*snapshot), workspace);
+      });
+    });
+  }
+}
+
+EncodableValue FlutterSnapshotSampler::Process(const Job& job,
+                                               Workspace* workspace) const {
+  const scoped_refptr<RTCVideoFrame>& frame = job.frame;
+  RTCVideoFrame::VideoRotation rotation = frame->rotation();
+  bool swap_sides = rotation == RTCVideoFrame::kVideoRotation_90 ||
+                    rotation == RTCVideoFrame::kVideoRotation_270;
+  int upright_width = swap_sides ? frame->height() : frame->width();
+  int upright_height = swap_sides ? frame->width() : frame->height();
+  if (upright_width <= 0 || upright_height <= 0)
+    return EncodableValue();
+
+  // Fit the upright picture in the box; the scaler only shrinks.
+  double scale = std::min({double(options_.max_width) / upright_width,
+                           double(options_.max_height) / upright_height, 1.0});
+  int width = std::max(1, static_cast<int>(std::lround(upright_width * scale)));
+  int height =
+      std::max(1, static_cast<int>(std::lround(upright_height * scale)));
+  int convert_width = swap_sides ? height : width;
+  int convert_height = swap_sides ? width : height;
+
+  workspace->pixels.resize(size_t(convert_width) * convert_height * 4);
+  ScaleI420ToRgba(I420PlanesFromFrame(*frame), convert_width, convert_height,
+                  RgbaLayout::kRGBA, workspace->pixels.data(),
+                  convert_width * 4, &workspace->scale_scratch);
+  const uint8_t* upright = workspace->pixels.data();
+  if (rotation != RTCVideoFrame::kVideoRotation_0) {
+    workspace->rotated.resize(workspace->pixels.size());
+    RotateRgba(workspace->pixels.data(), convert_width * 4, convert_width,
+               convert_height, rotation, workspace->rotated.data(), width * 4);
+    upright = workspace->rotated.data();
+  }
+  if (!EncodeImage(upright, width, height, width * 4, options_.encode,
+                   &workspace->encoded)) {
+    return EncodableValue();
+  }
+
+  EncodableMap snapshot;
+  snapshot[EncodableValue("trackId")] = EncodableValue(job.track_id);
+  snapshot[EncodableValue("width")] = EncodableValue(width);
+  snapshot[EncodableValue("height")] = EncodableValue(height);
+  if (options_.directory.empty()) {
+    snapshot[EncodableValue("data")] = EncodableValue(std::vector<uint8_t>(
+        workspace->encoded.begin(), workspace->encoded.end()));
+  } else {
+    const char* extension =
+        options_.encode.format == ImageFormat::kJpeg ? ".jpg" : ".png";
+    std::string path = options_.directory + "/" +
+                       FileNameForTrack(job.track_id) + "-" +
+                       std::to_string(job.sample_index % options_.ring_size) +
+                       extension;
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+      return EncodableValue();
+    bool written = fwrite(workspace->encoded.data(), 1,
+                          workspace->encoded.size(),
+                          file) == workspace->encoded.size();
+    if (fclose(file) != 0 || !written)
+      return EncodableValue();
+    snapshot[EncodableValue("path")] = EncodableValue(path);
+  }
+  return EncodableValue(snapshot);
+}
+
+void FlutterSnapshotSampler::OnProcessed(
+    EncodableValue snapshot,
+    std::shared_ptr<Workspace> workspace) {
+  in_flight_--;
+  idle_workspaces_.push_back(std::move(workspace));
+  if (stopped_)
+    return;
+  if (!snapshot.IsNull())
+    batch_.push_back(std::move(snapshot));
+  Dispatch();
+  // One event per round, sent once every track has been sampled and the
+  // round's encodes have all finished.
+  if (in_flight_ == 0 && pending_.empty() && awaiting_samples_ == 0)
+    FlushBatch();
+}
+
+void FlutterSnapshotSampler::FlushBatch() {
+  if (batch_.empty() || !event_channel_)
+    return;
+  EncodableMap params;
+  params[EncodableValue("event")] = "didCaptureSnapshots";
+  params[EncodableValue("snapshots")] = EncodableValue(std::move(batch_));
+  params[EncodableValue("snapshotsSkipped")] =
+      EncodableValue(static_cast<int64_t>(skipped_));
+  batch_ = EncodableList();
+  event_channel_->Success(EncodableValue(params), false);
+}
+
+}  // namespace flutter_webrtc_plugin
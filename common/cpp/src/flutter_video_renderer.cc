@@ -1,46 +1,347 @@
 #include "flutter_video_renderer.h"
 
+#include "flutter_composite_renderer.h"
+#include "flutter_snapshot_sampler.h"
+#include "flutter_worker_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
 namespace flutter_webrtc_plugin {
 
-FlutterVideoRenderer::~FlutterVideoRenderer() {}
+namespace {
+
+int64_t NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Fewest rows worth handing to a worker of their own.
+constexpr int kMinBandRows = 64;
+
+// The integer at |key| in |options|, or nothing if it is missing or not an
+// integer.
+std::optional<int64_t> IntOption(const EncodableMap& options,
+                                 std::string_view key) {
+  const EncodableValue* value = findValueRef(options, key);
+  if (value && TypeIs<int32_t>(*value))
+    return GetValue<int32_t>(*value);
+  if (value && TypeIs<int64_t>(*value))
+    return GetValue<int64_t>(*value);
+  return std::nullopt;
+}
+
+}  // namespace
+
+void FlutterVideoFrameHub::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
+  std::lock_guard<std::mutex> lock(sinks_mutex_);
+  for (VideoFrameSink* sink : sinks_) {
+    sink->OnFrame(frame);
+  }
+}
+
+void FlutterVideoFrameHub::Attach(VideoFrameSink* sink) {
+  std::lock_guard<std::mutex> lock(sinks_mutex_);
+  sinks_.push_back(sink);
+}
+
+bool FlutterVideoFrameHub::Detach(VideoFrameSink* sink) {
+  std::lock_guard<std::mutex> lock(sinks_mutex_);
+  sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sink), sinks_.end());
+  return sinks_.empty();
+}
+
+std::shared_ptr<const ConvertedVideoFrame> FlutterVideoFrameHub::Convert(
+    const scoped_refptr<RTCVideoFrame>& frame,
+    const VideoConversionKey& key,
+    const ConvertFunction& convert) {
+  auto find = [&]() {
+    return std::find_if(cache_.begin(), cache_.end(),
+                        [&](const CachedConversion& entry) {
+                          return entry.source == frame && entry.key == key;
+                        });
+  };
+
+  {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    auto it = find();
+    if (it != cache_.end()) {
+      // Another renderer got here first; wait for its result instead of
+      // converting the same pixels twice.
+      cache_cv_.wait(lock, [&]() {
+        it = find();
+        return it == cache_.end() || it->converted;
+      });
+      if (it != cache_.end())
+        return it->converted;
+    } else {
+      cache_.erase(std::remove_if(cache_.begin(), cache_.end(),
+                                  [&](const CachedConversion& entry) {
+                                    return entry.source != frame &&
+                                           entry.converted;
+                                  }),
+                   cache_.end());
+      cache_.push_back({frame, key, nullptr});
+    }
+  }
+
+  std::shared_ptr<const ConvertedVideoFrame> converted = convert();
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto it = find();
+    if (it != cache_.end())
+      it->converted = converted;
+  }
+  cache_cv_.notify_all();
+  return converted;
+}
+
+FlutterVideoRenderer::~FlutterVideoRenderer() {
+  StopConversionThread();
+}
 
 void FlutterVideoRenderer::initialize(
     TextureRegistrar* registrar,
     BinaryMessenger* messenger,
     std::unique_ptr<flutter::TextureVariant> texture,
-    int64_t trxture_id) {
+    int64_t trxture_id,
+    FlutterVideoRendererManager* manager,
+    std::shared_ptr<PixelBufferPool> buffer_pool) {
   registrar_ = registrar;
+  manager_ = manager;
+  buffer_pool_ = std::move(buffer_pool);
   texture_ = std::move(texture);
   texture_id_ = trxture_id;
   std::string channel_name =
       "FlutterWebRTC/Texture" + std::to_string(texture_id_);
   event_channel_ = EventChannelProxy::Create(messenger, channel_name);
+  conversion_thread_ = std::thread(&FlutterVideoRenderer::ConvertFrames, this);
 }
 
 const FlutterDesktopPixelBuffer* FlutterVideoRenderer::CopyPixelBuffer(
     size_t width,
     size_t height) const {
-  mutex_.lock();
-  if (pixel_buffer_.get() && frame_.get()) {
-    if (pixel_buffer_->width != frame_->width() ||
-        pixel_buffer_->height != frame_->height()) {
-      size_t buffer_size =
-          (size_t(frame_->width()) * size_t(frame_->height())) * (32 >> 3);
-      rgb_buffer_.reset(new uint8_t[buffer_size]);
-      pixel_buffer_->width = frame_->width();
-      pixel_buffer_->height = frame_->height();
+  if (width > 0 && height > 0) {
+    display_size_.store((uint64_t(width) << 32) | uint32_t(height),
+                        std::memory_order_relaxed);
+  }
+  std::lock_guard<std::mutex> lock(buffer_mutex_);
+  if (ready_.frame) {
+    front_ = std::move(ready_);
+    ready_ = PublishedFrame();
+    frames_rendered_.fetch_add(1, std::memory_order_relaxed);
+    display_latency_.Record(
+        std::chrono::microseconds(NowMicros() - front_.arrival_us));
+    ready_pending_ = false;
+    if (pacing_ == FramePacing::kVsync)
+      WakeConversionThread();
+  }
+  if (!front_.frame)
+    return nullptr;
+  if (front_.generation == served_generation_) {
+    conversions_avoided_.fetch_add(1, std::memory_order_relaxed);
+  }
+  served_generation_ = front_.generation;
+  return &front_.frame->pixel_buffer;
+}
+
+void FlutterVideoRenderer::ConvertFrames() {
+  while (!stop_conversion_) {
+    PendingFrame pending;
+    if (!CanConvert() || !pending_frame_.Take(&pending)) {
+      // Announce the wait before re-checking, so whoever makes progress
+      // possible either sees the flag and wakes us or is seen by the
+      // predicate.
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      conversion_waiting_ = true;
+      wake_cv_.wait(lock, [this] {
+        return stop_conversion_ || (CanConvert() && !pending_frame_.empty());
+      });
+      conversion_waiting_ = false;
+      continue;
+    }
+    const scoped_refptr<RTCVideoFrame>& frame = pending.frame;
+    scoped_refptr<FlutterVideoFrameHub> hub;
+    {
+      std::lock_guard<std::mutex> lock(hub_mutex_);
+      hub = hub_;
     }
 
-    frame_->ConvertToARGB(RTCVideoFrame::Type::kABGR, rgb_buffer_.get(), 0,
-                          static_cast<int>(pixel_buffer_->width),
-                          static_cast<int>(pixel_buffer_->height));
+    VideoConversionKey key;
+    key.rotation =
+        apply_rotation_ ? frame->rotation() : RTCVideoFrame::kVideoRotation_0;
+    bool swap_sides = key.rotation == RTCVideoFrame::kVideoRotation_90 ||
+                      key.rotation == RTCVideoFrame::kVideoRotation_270;
+    size_t frame_width = static_cast<size_t>(frame->width());
+    size_t frame_height = static_cast<size_t>(frame->height());
+    // The display size hint is in output orientation, so fit the rotated
+    // frame and convert at the un-rotated equivalent.
+    FrameSize size = swap_sides ? TargetSize(frame_height, frame_width)
+                                : TargetSize(frame_width, frame_height);
+    key.width = size.width;
+    key.height = size.height;
 
-    pixel_buffer_->buffer = rgb_buffer_.get();
-    mutex_.unlock();
-    return pixel_buffer_.get();
+    std::shared_ptr<const ConvertedVideoFrame> converted;
+    if (hub) {
+      bool converted_here = false;
+      converted = hub->Convert(frame, key, [&]() {
+        converted_here = true;
+        return ConvertFrame(frame, key);
+      });
+      if (!converted_here)
+        conversions_shared_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      converted = ConvertFrame(frame, key);
+    }
+
+    bool replaced = false;
+    {
+      // A ready frame the engine never picked up is simply replaced. The
+      // engine was already told about it and will pull the new one instead,
+      // so it need not be told again.
+      std::lock_guard<std::mutex> lock(buffer_mutex_);
+      replaced = ready_.frame != nullptr;
+      ready_.frame = std::move(converted);
+      ready_.generation = pending.generation;
+      ready_.arrival_us = pending.arrival_us;
+      ready_pending_ = true;
+    }
+    if (replaced) {
+      frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      registrar_->MarkTextureFrameAvailable(texture_id_);
+    }
+    MaybeSendStats();
   }
-  mutex_.unlock();
-  return nullptr;
+}
+
+EncodableMap FlutterVideoRenderer::Stats() const {
+  EncodableMap stats;
+  auto count = [&](const char* key, uint64_t value) {
+    stats[EncodableValue(key)] = EncodableValue(static_cast<int64_t>(value));
+  };
+  count("framesReceived", frames_delivered());
+  count("framesConverted", conversions_performed());
+  count("framesShown", frames_rendered());
+  count("framesDropped", frames_dropped());
+  count("conversionsAvoided", conversions_avoided());
+  count("conversionsShared", conversions_shared());
+  count("conversionsParallel", conversions_parallel());
+  auto percentiles = [&](const std::string& prefix,
+                         const LatencyHistogram& histogram) {
+    for (int percentile : {50, 95, 99}) {
+      std::string key = prefix + "P" + std::to_string(percentile) + "Us";
+      stats[EncodableValue(key)] =
+          EncodableValue(histogram.PercentileMicros(percentile));
+    }
+  };
+  percentiles("conversionTime", conversion_time_);
+  percentiles("frameToDisplay", display_latency_);
+  return stats;
+}
+
+void FlutterVideoRenderer::MaybeSendStats() {
+  int64_t interval_ms = stats_interval_ms_;
+  if (interval_ms <= 0)
+    return;
+  int64_t now = NowMicros();
+  if (now - last_stats_us_ < interval_ms * 1000)
+    return;
+  last_stats_us_ = now;
+  EncodableMap params = Stats();
+  params[EncodableValue("event")] = "didTextureStats";
+  params[EncodableValue("id")] = EncodableValue(texture_id_);
+  event_channel_->Success(EncodableValue(params));
+}
+
+std::shared_ptr<const ConvertedVideoFrame> FlutterVideoRenderer::ConvertFrame(
+    const scoped_refptr<RTCVideoFrame>& frame,
+    const VideoConversionKey& key) {
+  int64_t start_us = NowMicros();
+  auto converted = std::make_shared<ConvertedVideoFrame>();
+  size_t buffer_size = key.width * key.height * (32 >> 3);
+  converted->pixels = buffer_pool_->Acquire(buffer_size);
+  uint8_t* pixels = converted->pixels.data();
+  int stride = static_cast<int>(key.width * 4);
+  bool swap_sides = key.rotation == RTCVideoFrame::kVideoRotation_90 ||
+                    key.rotation == RTCVideoFrame::kVideoRotation_270;
+  int convert_width = static_cast<int>(swap_sides ? key.height : key.width);
+  int convert_height = static_cast<int>(swap_sides ? key.width : key.height);
+
+  // Large frames are split into horizontal bands converted side by side on
+  // the shared worker pool.
+  WorkerPool* pool = WorkerPool::Shared();
+  size_t bands = 1;
+  int64_t threshold = parallel_threshold_pixels_;
+  if (threshold > 0 && int64_t(frame->width()) * frame->height() >= threshold) {
+    bands = std::min(pool->size() + 1,
+                     static_cast<size_t>(convert_height / kMinBandRows));
+    bands = std::max<size_t>(bands, 1);
+  }
+  ConvertI420ToRgbaBands(I420PlanesFromFrame(*frame), convert_width,
+                         convert_height, key.rotation, bands, pool,
+                         RgbaLayout::kRGBA, pixels, stride, &band_scratch_);
+  if (bands > 1)
+    conversions_parallel_.fetch_add(1, std::memory_order_relaxed);
+  converted->pixel_buffer.buffer = pixels;
+  converted->pixel_buffer.width = key.width;
+  converted->pixel_buffer.height = key.height;
+  conversions_performed_.fetch_add(1, std::memory_order_relaxed);
+  conversion_time_.Record(std::chrono::microseconds(NowMicros() - start_us));
+  return converted;
+}
+
+FlutterVideoRenderer::FrameSize FlutterVideoRenderer::TargetSize(
+    size_t width,
+    size_t height) const {
+  if (!scale_to_display_ || width == 0 || height == 0)
+    return {width, height};
+  uint64_t display = display_size_.load(std::memory_order_relaxed);
+  size_t display_width = size_t(display >> 32);
+  size_t display_height = size_t(display & 0xffffffff);
+  if (display_width == 0 || display_height == 0 ||
+      (display_width >= width && display_height >= height)) {
+    return {width, height};
+  }
+  // Fit inside the display size, never upscale.
+  double scale = std::min(double(display_width) / double(width),
+                          double(display_height) / double(height));
+  size_t scaled_width = std::max<size_t>(1, std::lround(width * scale));
+  size_t scaled_height = std::max<size_t>(1, std::lround(height * scale));
+  return {std::min(scaled_width, width), std::min(scaled_height, height)};
+}
+
+void FlutterVideoRenderer::StopConversionThread() {
+  stop_conversion_ = true;
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+  }
+  wake_cv_.notify_one();
+  if (conversion_thread_.joinable())
+    conversion_thread_.join();
+}
+
+bool FlutterVideoRenderer::CanConvert() const {
+  return pacing_ != FramePacing::kVsync || !ready_pending_;
+}
+
+void FlutterVideoRenderer::WakeConversionThread() const {
+  if (conversion_waiting_) {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_cv_.notify_one();
+  }
+}
+
+void FlutterVideoRenderer::SetPacing(FramePacing pacing, double max_fps) {
+  int64_t interval_us = 0;
+  if (pacing == FramePacing::kMaxFps && max_fps > 0)
+    interval_us = static_cast<int64_t>(1e6 / max_fps);
+  min_frame_interval_us_ = interval_us;
+  pacing_ = pacing;
+  // Leaving vsync pacing may unblock a frame that is waiting.
+  WakeConversionThread();
 }
 
 void FlutterVideoRenderer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
@@ -49,46 +350,71 @@ void FlutterVideoRenderer::OnFrame(scoped_refptr<RTCVideoFrame> frame) {
     params[EncodableValue("event")] = "didFirstFrameRendered";
     params[EncodableValue("id")] = EncodableValue(texture_id_);
     event_channel_->Success(EncodableValue(params));
-    pixel_buffer_.reset(new FlutterDesktopPixelBuffer());
-    pixel_buffer_->width = 0;
-    pixel_buffer_->height = 0;
     first_frame_rendered = true;
   }
-  if (rotation_ != frame->rotation()) {
+  // With rotation applied natively the texture is always upright and
+  // already has the rotated dimensions.
+  RTCVideoFrame::VideoRotation rotation =
+      apply_rotation_ ? RTCVideoFrame::kVideoRotation_0 : frame->rotation();
+  size_t width = static_cast<size_t>(frame->width());
+  size_t height = static_cast<size_t>(frame->height());
+  RTCVideoFrame::VideoRotation frame_rotation = frame->rotation();
+  if (apply_rotation_ &&
+      (frame_rotation == RTCVideoFrame::kVideoRotation_90 ||
+       frame_rotation == RTCVideoFrame::kVideoRotation_270)) {
+    std::swap(width, height);
+  }
+  if (rotation_ != rotation) {
     EncodableMap params;
     params[EncodableValue("event")] = "didTextureChangeRotation";
     params[EncodableValue("id")] = EncodableValue(texture_id_);
-    params[EncodableValue("rotation")] =
-        EncodableValue((int32_t)frame->rotation());
+    params[EncodableValue("rotation")] = EncodableValue((int32_t)rotation);
     event_channel_->Success(EncodableValue(params));
-    rotation_ = frame->rotation();
+    rotation_ = rotation;
   }
-  if (last_frame_size_.width != frame->width() ||
-      last_frame_size_.height != frame->height()) {
+  if (last_frame_size_.width != width || last_frame_size_.height != height) {
     EncodableMap params;
     params[EncodableValue("event")] = "didTextureChangeVideoSize";
     params[EncodableValue("id")] = EncodableValue(texture_id_);
-    params[EncodableValue("width")] = EncodableValue((int32_t)frame->width());
-    params[EncodableValue("height")] = EncodableValue((int32_t)frame->height());
+    params[EncodableValue("width")] = EncodableValue((int32_t)width);
+    params[EncodableValue("height")] = EncodableValue((int32_t)height);
     event_channel_->Success(EncodableValue(params));
 
-    last_frame_size_ = {(size_t)frame->width(), (size_t)frame->height()};
+    last_frame_size_ = {width, height};
+  }
+  frames_delivered_.fetch_add(1, std::memory_order_relaxed);
+  if (pacing_ == FramePacing::kMaxFps) {
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::microseconds interval(min_frame_interval_us_.load());
+    // Allow some jitter, so a source running at exactly the maximum rate is
+    // not halved.
+    if (now + interval / 4 < next_frame_due_) {
+      frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    // Keep the cadence of the accepted frames, but never try to catch up
+    // after a gap.
+    next_frame_due_ = std::max(next_frame_due_ + interval, now);
   }
-  mutex_.lock();
-  frame_ = frame;
-  mutex_.unlock();
-  registrar_->MarkTextureFrameAvailable(texture_id_);
+  // Frames that arrive faster than they can be converted replace the
+  // pending one instead of queueing up.
+  if (!pending_frame_.Put({frame, ++frame_generation_, NowMicros()}))
+    frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+  WakeConversionThread();
 }
 
 void FlutterVideoRenderer::SetVideoTrack(scoped_refptr<RTCVideoTrack> track) {
   if (track_ != track) {
     if (track_)
-      track_->RemoveRenderer(this);
+      manager_->DetachFromTrack(track_, this);
     track_ = track;
     last_frame_size_ = {0, 0};
     first_frame_rendered = false;
+    scoped_refptr<FlutterVideoFrameHub> hub;
     if (track_)
-      track_->AddRenderer(this);
+      hub = manager_->AttachToTrack(track_, this);
+    std::lock_guard<std::mutex> lock(hub_mutex_);
+    hub_ = hub;
   }
 }
 
@@ -106,9 +432,60 @@ bool FlutterVideoRenderer::CheckVideoTrack(std::string mediaId) {
   return mediaId == track_->id().std_string();
 }
 
+namespace {
+
+typedef FlutterCompositeRenderer::Region CompositeRegion;
+
+// "grid" (the default) tiles the tracks in order; "custom" takes one
+// {x, y, width, height} rect per track, in canvas pixels.
+bool ParseCompositeLayout(const EncodableMap& layout,
+                          size_t track_count,
+                          size_t width,
+                          size_t height,
+                          std::vector<CompositeRegion>* regions,
+                          std::string* error) {
+  std::string type = findString(layout, "type");
+  if (type.empty() || type == "grid") {
+    *regions = FlutterCompositeRenderer::GridLayout(track_count, width, height);
+    return true;
+  }
+  if (type != "custom") {
+    *error = "unknown layout type " + type;
+    return false;
+  }
+  for (const EncodableValue& value : findList(layout, "rects")) {
+    if (!TypeIs<EncodableMap>(value)) {
+      *error = "layout rects must be maps";
+      return false;
+    }
+    const EncodableMap& rect = GetValue<EncodableMap>(value);
+    CompositeRegion region;
+    region.x = findInt(rect, "x");
+    region.y = findInt(rect, "y");
+    region.width = findInt(rect, "width");
+    region.height = findInt(rect, "height");
+    regions->push_back(region);
+  }
+  return true;
+}
+
+}  // namespace
+
 FlutterVideoRendererManager::FlutterVideoRendererManager(
     FlutterWebRTCBase* base)
-    : base_(base) {}
+    : base_(base), buffer_pool_(PixelBufferPool::Create()) {}
+
+FlutterVideoRendererManager::~FlutterVideoRendererManager() {
+  // Unhook every hub from its track before the renderers go away.
+  for (auto& renderer : renderers_) {
+    renderer.second->SetVideoTrack(nullptr);
+  }
+  for (auto& composite : composites_) {
+    composite.second->Clear();
+  }
+  if (snapshot_sampler_)
+    snapshot_sampler_->Stop();
+}
 
 void FlutterVideoRendererManager::CreateVideoRendererTexture(
     std::unique_ptr<MethodResultProxy> result) {
@@ -122,7 +499,8 @@ void FlutterVideoRendererManager::CreateVideoRendererTexture(
 
   auto texture_id = base_->textures_->RegisterTexture(textureVariant.get());
   texture->initialize(base_->textures_, base_->messenger_,
-                      std::move(textureVariant), texture_id);
+                      std::move(textureVariant), texture_id, this,
+                      buffer_pool_);
   renderers_[texture_id] = texture;
   EncodableMap params;
   params[EncodableValue("textureId")] = EncodableValue(texture_id);
@@ -167,12 +545,32 @@ void FlutterVideoRendererManager::VideoRendererDispose(
   auto it = renderers_.find(texture_id);
   if (it != renderers_.end()) {
     it->second->SetVideoTrack(nullptr);
+    // The renderer's buffers go back to the pool when it is destroyed; once
+    // the last renderer is gone nothing is left to reuse them.
 #if defined(_WINDOWS)
-    base_->textures_->UnregisterTexture(texture_id,
-                                        [&, it] { renderers_.erase(it); });
+    base_->textures_->UnregisterTexture(texture_id, [&, it] {
+      renderers_.erase(it);
+      if (renderers_.empty())
+        buffer_pool_->Trim(0);
+    });
 #else
     base_->textures_->UnregisterTexture(texture_id);
     renderers_.erase(it);
+    if (renderers_.empty())
+      buffer_pool_->Trim(0);
+#endif
+    result->Success();
+    return;
+  }
+  auto composite = composites_.find(texture_id);
+  if (composite != composites_.end()) {
+    composite->second->Clear();
+#if defined(_WINDOWS)
+    base_->textures_->UnregisterTexture(
+        texture_id, [&, composite] { composites_.erase(composite); });
+#else
+    base_->textures_->UnregisterTexture(texture_id);
+    composites_.erase(composite);
 #endif
     result->Success();
     return;
@@ -181,4 +579,295 @@ void FlutterVideoRendererManager::VideoRendererDispose(
                 "VideoRendererDispose() texture not found!");
 }
 
+void FlutterVideoRendererManager::CreateCompositeRenderer(
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int width = findInt(params, "width");
+  int height = findInt(params, "height");
+  if (width <= 0 || height <= 0) {
+    result->Error("CreateCompositeRendererFailed",
+                  "CreateCompositeRenderer() width and height are required");
+    return;
+  }
+  std::vector<scoped_refptr<RTCVideoTrack>> tracks =
+      VideoTracksForIds(findList(params, "trackIds"));
+  std::vector<FlutterCompositeRenderer::Region> regions;
+  std::string error;
+  if (!ParseCompositeLayout(findMap(params, "layout"), tracks.size(), width,
+                            height, &regions, &error)) {
+    result->Error("CreateCompositeRendererFailed",
+                  "CreateCompositeRenderer() " + error);
+    return;
+  }
+
+  auto composite = new RefCountedObject<FlutterCompositeRenderer>();
+  auto textureVariant =
+      std::make_unique<flutter::TextureVariant>(flutter::PixelBufferTexture(
+          [composite](size_t width,
+                      size_t height) -> const FlutterDesktopPixelBuffer* {
+            return composite->CopyPixelBuffer(width, height);
+          }));
+  auto texture_id = base_->textures_->RegisterTexture(textureVariant.get());
+  composite->initialize(base_->textures_, std::move(textureVariant),
+                        texture_id, this, buffer_pool_);
+  composite->SetMaxFps(findInt(params, "maxFps"));
+  composite->SetLayout(width, height, std::move(tracks), std::move(regions));
+  composites_[texture_id] = composite;
+  EncodableMap response;
+  response[EncodableValue("textureId")] = EncodableValue(texture_id);
+  result->Success(EncodableValue(response));
+}
+
+void FlutterVideoRendererManager::CompositeRendererSetLayout(
+    int64_t texture_id,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = composites_.find(texture_id);
+  if (it == composites_.end()) {
+    result->Error("CompositeRendererSetLayoutFailed",
+                  "CompositeRendererSetLayout() texture not found!");
+    return;
+  }
+  FlutterCompositeRenderer* composite = it->second.get();
+  int width = findInt(params, "width");
+  int height = findInt(params, "height");
+  size_t canvas_width = width > 0 ? size_t(width) : composite->width();
+  size_t canvas_height = height > 0 ? size_t(height) : composite->height();
+  const EncodableList* track_ids = findListRef(params, "trackIds");
+  std::vector<scoped_refptr<RTCVideoTrack>> tracks =
+      track_ids ? VideoTracksForIds(*track_ids) : composite->tracks();
+  std::vector<FlutterCompositeRenderer::Region> regions;
+  std::string error;
+  if (!ParseCompositeLayout(findMap(params, "layout"), tracks.size(),
+                            canvas_width, canvas_height, &regions, &error)) {
+    result->Error("CompositeRendererSetLayoutFailed",
+                  "CompositeRendererSetLayout() " + error);
+    return;
+  }
+  composite->SetLayout(canvas_width, canvas_height, std::move(tracks),
+                       std::move(regions));
+  result->Success();
+}
+
+std::vector<scoped_refptr<RTCVideoTrack>>
+FlutterVideoRendererManager::VideoTracksForIds(
+    const EncodableList& track_ids) {
+  std::vector<scoped_refptr<RTCVideoTrack>> tracks;
+  for (const EncodableValue& id : track_ids) {
+    scoped_refptr<RTCMediaTrack> track;
+    if (TypeIs<std::string>(id))
+      track = base_->MediaTracksForId(GetValue<std::string>(id));
+    if (track && track->kind().std_string() == "video") {
+      tracks.push_back(static_cast<RTCVideoTrack*>(track.get()));
+    } else {
+      tracks.push_back(nullptr);
+    }
+  }
+  return tracks;
+}
+
+std::vector<std::pair<std::string, scoped_refptr<RTCVideoTrack>>>
+FlutterVideoRendererManager::SnapshotTracksForIds(
+    const EncodableList& track_ids) {
+  std::vector<scoped_refptr<RTCVideoTrack>> tracks =
+      VideoTracksForIds(track_ids);
+  std::vector<std::pair<std::string, scoped_refptr<RTCVideoTrack>>> entries;
+  for (size_t i = 0; i < tracks.size(); i++) {
+    if (tracks[i])
+      entries.emplace_back(GetValue<std::string>(track_ids[i]), tracks[i]);
+  }
+  return entries;
+}
+
+void FlutterVideoRendererManager::StartSnapshotSampler(
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  FlutterSnapshotSampler::Options options;
+  int interval_ms = findInt(params, "intervalMs");
+  if (interval_ms > 0)
+    options.interval = std::chrono::milliseconds(interval_ms);
+  int max_width = findInt(params, "maxWidth");
+  if (max_width > 0)
+    options.max_width = max_width;
+  int max_height = findInt(params, "maxHeight");
+  if (max_height > 0)
+    options.max_height = max_height;
+  // Thumbnails default to JPEG; PNG is several times larger.
+  options.encode.format = ImageFormat::kJpeg;
+  options.encode.quality = 75;
+  std::string format = findString(params, "format");
+  if (!format.empty() &&
+      !ImageFormatFromName(format, &options.encode.format)) {
+    result->Error("StartSnapshotSamplerFailed",
+                  "StartSnapshotSampler() unsupported format " + format);
+    return;
+  }
+  int quality = findInt(params, "quality");
+  if (quality > 0)
+    options.encode.quality = quality;
+  options.directory = findString(params, "directory");
+  int ring_size = findInt(params, "ringSize");
+  if (ring_size > 0)
+    options.ring_size = ring_size;
+  int max_encodes = findInt(params, "maxConcurrentEncodes");
+  if (max_encodes > 0)
+    options.max_concurrent_encodes = max_encodes;
+
+  if (snapshot_sampler_)
+    snapshot_sampler_->Stop();
+  snapshot_sampler_ = std::make_shared<FlutterSnapshotSampler>(
+      this, base_->event_channel(), options);
+  snapshot_sampler_->SetTracks(
+      SnapshotTracksForIds(findList(params, "trackIds")));
+  snapshot_sampler_->Start();
+  result->Success();
+}
+
+void FlutterVideoRendererManager::SnapshotSamplerSetTracks(
+    const EncodableList& track_ids,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!snapshot_sampler_) {
+    result->Error("SnapshotSamplerSetTracksFailed",
+                  "SnapshotSamplerSetTracks() sampler is not running");
+    return;
+  }
+  snapshot_sampler_->SetTracks(SnapshotTracksForIds(track_ids));
+  result->Success();
+}
+
+void FlutterVideoRendererManager::StopSnapshotSampler(
+    std::unique_ptr<MethodResultProxy> result) {
+  if (snapshot_sampler_) {
+    snapshot_sampler_->Stop();
+    snapshot_sampler_ = nullptr;
+  }
+  result->Success();
+}
+
+void FlutterVideoRendererManager::VideoRendererSetOptions(
+    int64_t texture_id,
+    const EncodableMap& options,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = renderers_.find(texture_id);
+  if (it == renderers_.end()) {
+    result->Error("VideoRendererSetOptionsFailed",
+                  "VideoRendererSetOptions() texture not found!");
+    return;
+  }
+  // Every option is checked before any is applied, so a rejected call
+  // leaves the renderer as it was.
+  auto invalid = [&](const std::string& option) {
+    result->Error("VideoRendererSetOptionsFailed",
+                  "VideoRendererSetOptions() invalid " + option);
+  };
+  const EncodableValue* scale_to_display =
+      findValueRef(options, "scaleToDisplay");
+  if (scale_to_display && !TypeIs<bool>(*scale_to_display))
+    return invalid("scaleToDisplay");
+  const EncodableValue* apply_rotation = findValueRef(options, "applyRotation");
+  if (apply_rotation && !TypeIs<bool>(*apply_rotation))
+    return invalid("applyRotation");
+  std::optional<int64_t> parallel_threshold;
+  if (findValueRef(options, "parallelConversionThreshold")) {
+    parallel_threshold = IntOption(options, "parallelConversionThreshold");
+    if (!parallel_threshold)
+      return invalid("parallelConversionThreshold");
+  }
+  std::optional<int64_t> stats_interval;
+  if (findValueRef(options, "statsIntervalMs")) {
+    stats_interval = IntOption(options, "statsIntervalMs");
+    if (!stats_interval)
+      return invalid("statsIntervalMs");
+  }
+  std::optional<FramePacing> pacing;
+  double max_fps = 0;
+  if (const EncodableValue* pacing_value = findValueRef(options, "pacing")) {
+    const std::string* name = std::get_if<std::string>(pacing_value);
+    if (!name)
+      return invalid("pacing");
+    if (*name == "latestOnly") {
+      pacing = FramePacing::kLatestOnly;
+    } else if (*name == "vsync") {
+      pacing = FramePacing::kVsync;
+    } else if (*name == "maxFps") {
+      const EncodableValue* max_fps_value = findValueRef(options, "maxFps");
+      if (max_fps_value && TypeIs<double>(*max_fps_value)) {
+        max_fps = GetValue<double>(*max_fps_value);
+      } else if (std::optional<int64_t> fps = IntOption(options, "maxFps")) {
+        max_fps = static_cast<double>(*fps);
+      }
+      if (!(max_fps > 0))
+        return invalid("maxFps");
+      pacing = FramePacing::kMaxFps;
+    } else {
+      return invalid("pacing " + *name);
+    }
+  }
+
+  FlutterVideoRenderer* renderer = it->second.get();
+  if (scale_to_display)
+    renderer->SetScaleToDisplay(GetValue<bool>(*scale_to_display));
+  if (apply_rotation)
+    renderer->SetApplyRotation(GetValue<bool>(*apply_rotation));
+  if (parallel_threshold)
+    renderer->SetParallelConversionThreshold(*parallel_threshold);
+  if (stats_interval)
+    renderer->SetStatsInterval(std::chrono::milliseconds(*stats_interval));
+  if (pacing)
+    renderer->SetPacing(*pacing, max_fps);
+  result->Success();
+}
+
+void FlutterVideoRendererManager::VideoRendererGetStats(
+    int64_t texture_id,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto it = renderers_.find(texture_id);
+  if (it == renderers_.end()) {
+    result->Error("VideoRendererGetStatsFailed",
+                  "VideoRendererGetStats() texture not found!");
+    return;
+  }
+  result->Success(EncodableValue(it->second->Stats()));
+}
+
+void FlutterVideoRendererManager::VideoRendererGetPoolStats(
+    std::unique_ptr<MethodResultProxy> result) {
+  PixelBufferPool::Stats stats = buffer_pool_->stats();
+  EncodableMap params;
+  params[EncodableValue("bytesInUse")] =
+      EncodableValue(static_cast<int64_t>(stats.bytes_in_use));
+  params[EncodableValue("bytesIdle")] =
+      EncodableValue(static_cast<int64_t>(stats.bytes_idle));
+  params[EncodableValue("hits")] =
+      EncodableValue(static_cast<int64_t>(stats.hits));
+  params[EncodableValue("misses")] =
+      EncodableValue(static_cast<int64_t>(stats.misses));
+  result->Success(EncodableValue(params));
+}
+
+scoped_refptr<FlutterVideoFrameHub> FlutterVideoRendererManager::AttachToTrack(
+    scoped_refptr<RTCVideoTrack> track,
+    VideoFrameSink* sink) {
+  scoped_refptr<FlutterVideoFrameHub>& hub = hubs_[track.get()];
+  bool subscribe = !hub;
+  if (subscribe)
+    hub = new RefCountedObject<FlutterVideoFrameHub>();
+  hub->Attach(sink);
+  if (subscribe)
+    track->AddRenderer(hub.get());
+  return hub;
+}
+
+void FlutterVideoRendererManager::DetachFromTrack(
+    scoped_refptr<RTCVideoTrack> track,
+    VideoFrameSink* sink) {
+  auto it = hubs_.find(track.get());
+  if (it == hubs_.end())
+    return;
+  if (it->second->Detach(sink)) {
+    track->RemoveRenderer(it->second.get());
+    hubs_.erase(it);
+  }
+}
+
 }  // namespace flutter_webrtc_plugin
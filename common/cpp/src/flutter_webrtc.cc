@@ -1,5 +1,6 @@
 #include "flutter_webrtc.h"
 
+#include "flutter_method_batch.h"
 #include "flutter_webrtc/flutter_web_r_t_c_plugin.h"
 
 namespace flutter_webrtc_plugin {
@@ -12,1198 +13,1658 @@ FlutterWebRTC::FlutterWebRTC(FlutterWebRTCPlugin* plugin)
       FlutterPeerConnection::FlutterPeerConnection(this),
       FlutterScreenCapture::FlutterScreenCapture(this),
       FlutterDataChannel::FlutterDataChannel(this),
-      FlutterFrameCryptor::FlutterFrameCryptor(this) {}
+      FlutterFrameCryptor::FlutterFrameCryptor(this),
+      FlutterMediaRecorderManager::FlutterMediaRecorderManager(this) {}
 
 FlutterWebRTC::~FlutterWebRTC() {}
 
 void FlutterWebRTC::HandleMethodCall(
     const MethodCallProxy& method_call,
     std::unique_ptr<MethodResultProxy> result) {
-  if (method_call.method_name().compare("initialize") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap options = findMap(params, "options");
-    result->Success();
-  } else if (method_call.method_name().compare("createPeerConnection") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap configuration = findMap(params, "configuration");
-    const EncodableMap constraints = findMap(params, "constraints");
-    CreateRTCPeerConnection(configuration, constraints, std::move(result));
-  } else if (method_call.method_name().compare("getUserMedia") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap constraints = findMap(params, "constraints");
-    GetUserMedia(constraints, std::move(result));
-  } else if (method_call.method_name().compare("getDisplayMedia") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap constraints = findMap(params, "constraints");
-
-    GetDisplayMedia(constraints, std::move(result));
-  } else if (method_call.method_name().compare("getDesktopSources") == 0) {
-    // types: ["screen", "window"]
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  Dispatch(method_call.method_name(), method_call.arguments(),
+           std::move(result));
+}
 
-    const EncodableList types = findList(params, "types");
-    if (types.empty()) {
-      result->Error("Bad Arguments", "Types is required");
-      return;
-    }
-    GetDesktopSources(types, std::move(result));
-  } else if (method_call.method_name().compare("updateDesktopSources") == 0) {
-    // types: ["screen", "window"]
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::Dispatch(const std::string& method_name,
+                             const EncodableValue* arguments,
+                             std::unique_ptr<MethodResultProxy> result) {
+  MethodHandler handler = FindMethodHandler(method_name);
+  if (handler != nullptr) {
+    (this->*handler)(arguments, std::move(result));
+  } else if (HandleFrameCryptorMethodCall(method_name, arguments,
+                                          std::move(result), &result)) {
+    // Do nothing
+  } else {
+    result->NotImplemented();
+  }
+}
 
-    const EncodableList types = findList(params, "types");
-    if (types.empty()) {
-      result->Error("Bad Arguments", "Types is required");
-      return;
-    }
-    UpdateDesktopSources(types, std::move(result));
-  } else if (method_call.method_name().compare("getDesktopSourceThumbnail") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+FlutterWebRTC::MethodHandler FlutterWebRTC::FindMethodHandler(
+    const std::string& method_name) {
+  // Must stay sorted by name, it is looked up with a binary search.
+  static constexpr MethodEntry kMethodHandlers[] = {
+      {"addCandidate", &FlutterWebRTC::HandleAddCandidate},
+      {"addCandidates", &FlutterWebRTC::HandleAddCandidates},
+      {"addStream", &FlutterWebRTC::HandleAddStream},
+      {"addTrack", &FlutterWebRTC::HandleAddTrack},
+      {"addTransceiver", &FlutterWebRTC::HandleAddTransceiver},
+      {"canInsertDtmf", &FlutterWebRTC::HandleCanInsertDtmf},
+      {"captureFrame", &FlutterWebRTC::HandleCaptureFrame},
+      {"compositeRendererSetLayout",
+       &FlutterWebRTC::HandleCompositeRendererSetLayout},
+      {"createAnswer", &FlutterWebRTC::HandleCreateAnswer},
+      {"createCompositeRenderer",
+       &FlutterWebRTC::HandleCreateCompositeRenderer},
+      {"createDataChannel", &FlutterWebRTC::HandleCreateDataChannel},
+      {"createLocalMediaStream", &FlutterWebRTC::HandleCreateLocalMediaStream},
+      {"createOffer", &FlutterWebRTC::HandleCreateOffer},
+      {"createPeerConnection", &FlutterWebRTC::HandleCreatePeerConnection},
+      {"createVideoRenderer", &FlutterWebRTC::HandleCreateVideoRenderer},
+      {"dataChannelClose", &FlutterWebRTC::HandleDataChannelClose},
+      {"dataChannelSend", &FlutterWebRTC::HandleDataChannelSend},
+      {"executeBatch", &FlutterWebRTC::HandleExecuteBatch},
+      {"getConnectionState", &FlutterWebRTC::HandleGetConnectionState},
+      {"getDesktopSourceThumbnail",
+       &FlutterWebRTC::HandleGetDesktopSourceThumbnail},
+      {"getDesktopSources", &FlutterWebRTC::HandleGetDesktopSources},
+      {"getDisplayMedia", &FlutterWebRTC::HandleGetDisplayMedia},
+      {"getIceConnectionState", &FlutterWebRTC::HandleGetIceConnectionState},
+      {"getIceGatheringState", &FlutterWebRTC::HandleGetIceGatheringState},
+      {"getLocalDescription", &FlutterWebRTC::HandleGetLocalDescription},
+      {"getReceivers", &FlutterWebRTC::HandleGetReceivers},
+      {"getRemoteDescription", &FlutterWebRTC::HandleGetRemoteDescription},
+      {"getRtpReceiverCapabilities",
+       &FlutterWebRTC::HandleGetRtpReceiverCapabilities},
+      {"getRtpSenderCapabilities",
+       &FlutterWebRTC::HandleGetRtpSenderCapabilities},
+      {"getSenders", &FlutterWebRTC::HandleGetSenders},
+      {"getSignalingState", &FlutterWebRTC::HandleGetSignalingState},
+      {"getSources", &FlutterWebRTC::HandleGetSources},
+      {"getStats", &FlutterWebRTC::HandleGetStats},
+      {"getTransceivers", &FlutterWebRTC::HandleGetTransceivers},
+      {"getUserMedia", &FlutterWebRTC::HandleGetUserMedia},
+      {"initialize", &FlutterWebRTC::HandleInitialize},
+      {"mediaStreamAddTrack", &FlutterWebRTC::HandleMediaStreamAddTrack},
+      {"mediaStreamGetTracks", &FlutterWebRTC::HandleMediaStreamGetTracks},
+      {"mediaStreamRemoveTrack", &FlutterWebRTC::HandleMediaStreamRemoveTrack},
+      {"mediaStreamTrackSetEnable",
+       &FlutterWebRTC::HandleMediaStreamTrackSetEnable},
+      {"mediaStreamTrackSwitchCamera",
+       &FlutterWebRTC::HandleMediaStreamTrackSwitchCamera},
+      {"peerConnectionClose", &FlutterWebRTC::HandlePeerConnectionClose},
+      {"peerConnectionDispose", &FlutterWebRTC::HandlePeerConnectionDispose},
+      {"removeStream", &FlutterWebRTC::HandleRemoveStream},
+      {"removeTrack", &FlutterWebRTC::HandleRemoveTrack},
+      {"restartIce", &FlutterWebRTC::HandleRestartIce},
+      {"rtpSenderReplaceTrack", &FlutterWebRTC::HandleRtpSenderReplaceTrack},
+      {"rtpSenderSetParameters", &FlutterWebRTC::HandleRtpSenderSetParameters},
+      {"rtpSenderSetStreams", &FlutterWebRTC::HandleRtpSenderSetStreams},
+      {"rtpSenderSetTrack", &FlutterWebRTC::HandleRtpSenderSetTrack},
+      {"rtpTransceiverGetCurrentDirection",
+       &FlutterWebRTC::HandleRtpTransceiverGetCurrentDirection},
+      {"rtpTransceiverSetDirection",
+       &FlutterWebRTC::HandleRtpTransceiverSetDirection},
+      {"rtpTransceiverStop", &FlutterWebRTC::HandleRtpTransceiverStop},
+      {"selectAudioInput", &FlutterWebRTC::HandleSelectAudioInput},
+      {"selectAudioOutput", &FlutterWebRTC::HandleSelectAudioOutput},
+      {"sendDtmf", &FlutterWebRTC::HandleSendDtmf},
+      {"setCodecPreferences", &FlutterWebRTC::HandleSetCodecPreferences},
+      {"setConfiguration", &FlutterWebRTC::HandleSetConfiguration},
+      {"setLocalDescription", &FlutterWebRTC::HandleSetLocalDescription},
+      {"setRemoteDescription", &FlutterWebRTC::HandleSetRemoteDescription},
+      {"setVolume", &FlutterWebRTC::HandleSetVolume},
+      {"snapshotSamplerSetTracks",
+       &FlutterWebRTC::HandleSnapshotSamplerSetTracks},
+      {"startRecordToFile", &FlutterWebRTC::HandleStartRecordToFile},
+      {"startSnapshotSampler", &FlutterWebRTC::HandleStartSnapshotSampler},
+      {"stopRecordToFile", &FlutterWebRTC::HandleStopRecordToFile},
+      {"stopSnapshotSampler", &FlutterWebRTC::HandleStopSnapshotSampler},
+      {"streamDispose", &FlutterWebRTC::HandleStreamDispose},
+      {"trackDispose", &FlutterWebRTC::HandleTrackDispose},
+      {"updateDesktopSources", &FlutterWebRTC::HandleUpdateDesktopSources},
+      {"videoRendererDispose", &FlutterWebRTC::HandleVideoRendererDispose},
+      {"videoRendererGetPoolStats",
+       &FlutterWebRTC::HandleVideoRendererGetPoolStats},
+      {"videoRendererGetStats", &FlutterWebRTC::HandleVideoRendererGetStats},
+      {"videoRendererSetOptions",
+       &FlutterWebRTC::HandleVideoRendererSetOptions},
+      {"videoRendererSetSrcObject",
+       &FlutterWebRTC::HandleVideoRendererSetSrcObject},
+  };
+  static_assert(IsSortedByName(kMethodHandlers),
+                "kMethodHandlers must be sorted by method name");
+
+  const MethodEntry* entry = FindByName(kMethodHandlers, method_name);
+  return entry ? entry->handler : nullptr;
+}
 
-    std::string sourceId = findString(params, "sourceId");
-    if (sourceId.empty()) {
-      result->Error("Bad Arguments", "Incorrect sourceId");
-      return;
-    }
-    const EncodableMap thumbnailSize = findMap(params, "thumbnailSize");
-    if (!thumbnailSize.empty()) {
-      int width = 0;
-      int height = 0;
-      GetDesktopSourceThumbnail(sourceId, width, height, std::move(result));
-    } else {
-      result->Error("Bad Arguments", "Bad arguments received");
-    }
-  } else if (method_call.method_name().compare("getSources") == 0) {
-    GetSources(std::move(result));
-  } else if (method_call.method_name().compare("selectAudioInput") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string deviceId = findString(params, "deviceId");
-    SelectAudioInput(deviceId, std::move(result));
-  } else if (method_call.method_name().compare("selectAudioOutput") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string deviceId = findString(params, "deviceId");
-    SelectAudioOutput(deviceId, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamGetTracks") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    MediaStreamGetTracks(streamId, std::move(result));
-  } else if (method_call.method_name().compare("createOffer") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "constraints");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createOfferFailed",
-                    "createOffer() peerConnection is null");
-      return;
-    }
-    CreateOffer(constraints, pc, std::move(result));
-  } else if (method_call.method_name().compare("createAnswer") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "constraints");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createAnswerFailed",
-                    "createAnswer() peerConnection is null");
-      return;
-    }
-    CreateAnswer(constraints, pc, std::move(result));
-  } else if (method_call.method_name().compare("addStream") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (!stream) {
-      result->Error("addStreamFailed", "addStream() stream not found!");
-      return;
-    }
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addStreamFailed", "addStream() peerConnection is null");
-      return;
-    }
-    pc->AddStream(stream);
+void FlutterWebRTC::HandleInitialize(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  result->Success();
+}
+
+void FlutterWebRTC::HandleCreatePeerConnection(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const ArgView configuration = params.Map("configuration");
+  const ArgView constraints = params.Map("constraints");
+  CreateRTCPeerConnection(configuration.map(), constraints.map(),
+                          std::move(result));
+}
+
+void FlutterWebRTC::HandleGetUserMedia(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const ArgView constraints = params.Map("constraints");
+  GetUserMedia(constraints.map(), std::move(result));
+}
+
+void FlutterWebRTC::HandleGetDisplayMedia(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const ArgView constraints = params.Map("constraints");
+
+  GetDisplayMedia(constraints.map(), std::move(result));
+}
+
+void FlutterWebRTC::HandleGetDesktopSources(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  // types: ["screen", "window"]
+  if (!arguments) {
+    result->Error("Bad Arguments", "Bad arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const EncodableList& types = params.List("types");
+  if (types.empty()) {
+    result->Error("Bad Arguments", "Types is required");
+    return;
+  }
+  GetDesktopSources(types, std::move(result));
+}
+
+void FlutterWebRTC::HandleUpdateDesktopSources(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  // types: ["screen", "window"]
+  if (!arguments) {
+    result->Error("Bad Arguments", "Bad arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const EncodableList& types = params.List("types");
+  if (types.empty()) {
+    result->Error("Bad Arguments", "Types is required");
+    return;
+  }
+  UpdateDesktopSources(types, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetDesktopSourceThumbnail(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Bad arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const std::string& sourceId = params.String("sourceId");
+  if (sourceId.empty()) {
+    result->Error("Bad Arguments", "Incorrect sourceId");
+    return;
+  }
+  const ArgView thumbnailSize = params.Map("thumbnailSize");
+  if (!thumbnailSize.empty()) {
+    int width = 0;
+    int height = 0;
+    GetDesktopSourceThumbnail(sourceId, width, height, std::move(result));
+  } else {
+    result->Error("Bad Arguments", "Bad arguments received");
+  }
+}
+
+void FlutterWebRTC::HandleGetSources(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  GetSources(std::move(result));
+}
+
+void FlutterWebRTC::HandleSelectAudioInput(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  const ArgView params(arguments);
+  const std::string& deviceId = params.String("deviceId");
+  SelectAudioInput(deviceId, std::move(result));
+}
+
+void FlutterWebRTC::HandleSelectAudioOutput(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  const ArgView params(arguments);
+  const std::string& deviceId = params.String("deviceId");
+  SelectAudioOutput(deviceId, std::move(result));
+}
+
+void FlutterWebRTC::HandleMediaStreamGetTracks(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& streamId = params.String("streamId");
+  MediaStreamGetTracks(streamId, std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateOffer(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const ArgView constraints = params.Map("constraints");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("createOfferFailed",
+                  "createOffer() peerConnection is null");
+    return;
+  }
+  CreateOffer(constraints.map(), pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateAnswer(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const ArgView constraints = params.Map("constraints");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("createAnswerFailed",
+                  "createAnswer() peerConnection is null");
+    return;
+  }
+  CreateAnswer(constraints.map(), pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleAddStream(const EncodableValue* arguments,
+                                    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& streamId = params.String("streamId");
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (!stream) {
+    result->Error("addStreamFailed", "addStream() stream not found!");
+    return;
+  }
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addStreamFailed", "addStream() peerConnection is null");
+    return;
+  }
+  pc->AddStream(stream);
+  result->Success();
+}
+
+void FlutterWebRTC::HandleRemoveStream(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& streamId = params.String("streamId");
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (!stream) {
+    result->Error("removeStreamFailed", "removeStream() stream not found!");
+    return;
+  }
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("removeStreamFailed",
+                  "removeStream() peerConnection is null");
+    return;
+  }
+  pc->RemoveStream(stream);
+  result->Success();
+}
+
+void FlutterWebRTC::HandleSetLocalDescription(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const ArgView constraints = params.Map("description");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setLocalDescriptionFailed",
+                  "setLocalDescription() peerConnection is null");
+    return;
+  }
+
+  SdpParseError error;
+  scoped_refptr<RTCSessionDescription> description =
+      RTCSessionDescription::Create(constraints.String("type").c_str(),
+                                    constraints.String("sdp").c_str(),
+                                    &error);
+
+  if (description.get() != nullptr) {
+    SetLocalDescription(description.get(), pc, std::move(result));
+  } else {
+    result->Error("setLocalDescriptionFailed", "Invalid type or sdp");
+  }
+}
+
+void FlutterWebRTC::HandleSetRemoteDescription(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const ArgView constraints = params.Map("description");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setRemoteDescriptionFailed",
+                  "setRemoteDescription() peerConnection is null");
+    return;
+  }
+
+  SdpParseError error;
+  scoped_refptr<RTCSessionDescription> description =
+      RTCSessionDescription::Create(constraints.String("type").c_str(),
+                                    constraints.String("sdp").c_str(),
+                                    &error);
+
+  if (description.get() != nullptr) {
+    SetRemoteDescription(description.get(), pc, std::move(result));
+  } else {
+    result->Error("setRemoteDescriptionFailed", "Invalid type or sdp");
+  }
+}
+
+void FlutterWebRTC::HandleAddCandidate(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const ArgView constraints = params.Map("candidate");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addCandidateFailed",
+                  "addCandidate() peerConnection is null");
+    return;
+  }
+
+  SdpParseError error;
+  const std::string& candidate = constraints.String("candidate");
+  if (candidate.empty()) {
+    // received the end-of-candidates
     result->Success();
-  } else if (method_call.method_name().compare("removeStream") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (!stream) {
-      result->Error("removeStreamFailed", "removeStream() stream not found!");
-      return;
-    }
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("removeStreamFailed",
-                    "removeStream() peerConnection is null");
-      return;
-    }
-    pc->RemoveStream(stream);
+    return;
+  }
+  int sdpMLineIndex = constraints.Int("sdpMLineIndex");
+  scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
+      candidate.c_str(), constraints.String("sdpMid").c_str(),
+      sdpMLineIndex == -1 ? 0 : sdpMLineIndex, &error);
+
+  if (rtc_candidate.get() != nullptr) {
+    AddIceCandidate(rtc_candidate.get(), pc, std::move(result));
+  } else {
+    result->Error("addCandidateFailed", "Invalid candidate");
+  }
+}
+
+void FlutterWebRTC::HandleAddCandidates(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addCandidatesFailed",
+                  "addCandidates() peerConnection is null");
+    return;
+  }
+  AddIceCandidates(params.List("candidates"), pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetStats(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const std::string& track_id = params.String("trackId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getStatsFailed", "getStats() peerConnection is null");
+    return;
+  }
+  GetStats(track_id, pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateDataChannel(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("createDataChannelFailed",
+                  "createDataChannel() peerConnection is null");
+    return;
+  }
+
+  const std::string& label = params.String("label");
+  const ArgView dataChannelDict = params.Map("dataChannelDict");
+
+  CreateDataChannel(peerConnectionId, label, dataChannelDict.map(), pc,
+                    std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelSend(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("dataChannelSendFailed",
+                  "dataChannelSend() peerConnection is null");
+    return;
+  }
+
+  const std::string& dataChannelId = params.String("dataChannelId");
+  const std::string& type = params.String("type");
+  const EncodableValue& data = params.Value("data");
+  RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
+  if (data_channel == nullptr) {
+    result->Error("dataChannelSendFailed",
+                  "dataChannelSend() data_channel is null");
+    return;
+  }
+  DataChannelSend(data_channel, type, data, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelClose(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("dataChannelCloseFailed",
+                  "dataChannelClose() peerConnection is null");
+    return;
+  }
+
+  const std::string& dataChannelId = params.String("dataChannelId");
+  RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
+  if (data_channel == nullptr) {
+    result->Error("dataChannelCloseFailed",
+                  "dataChannelClose() data_channel is null");
+    return;
+  }
+  DataChannelClose(data_channel, dataChannelId, std::move(result));
+}
+
+void FlutterWebRTC::HandleStreamDispose(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& stream_id = params.String("streamId");
+  MediaStreamDispose(stream_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleMediaStreamTrackSetEnable(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& track_id = params.String("trackId");
+  const EncodableValue& enable = params.Value("enabled");
+  RTCMediaTrack* track = MediaTrackForId(track_id);
+  if (track != nullptr) {
+    track->set_enabled(GetValue<bool>(enable));
+  }
+  result->Success();
+}
+
+void FlutterWebRTC::HandleTrackDispose(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& track_id = params.String("trackId");
+  MediaStreamTrackDispose(track_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleRestartIce(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("restartIceFailed", "restartIce() peerConnection is null");
+    return;
+  }
+  pc->RestartIce();
+  result->Success();
+}
+
+void FlutterWebRTC::HandlePeerConnectionClose(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("peerConnectionCloseFailed",
+                  "peerConnectionClose() peerConnection is null");
+    return;
+  }
+  RTCPeerConnectionClose(pc, peerConnectionId, std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionDispose(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
     result->Success();
-  } else if (method_call.method_name().compare("setLocalDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
+    return;
+  }
+  RTCPeerConnectionDispose(pc, peerConnectionId, std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateVideoRenderer(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  CreateVideoRendererTexture(std::move(result));
+}
+
+void FlutterWebRTC::HandleVideoRendererDispose(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  int64_t texture_id = params.LongInt("textureId");
+  VideoRendererDispose(texture_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleVideoRendererSetSrcObject(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& stream_id = params.String("streamId");
+  int64_t texture_id = params.LongInt("textureId");
+  const std::string& owner_tag = params.String("ownerTag");
+  const std::string& track_id = params.String("trackId");
+
+  VideoRendererSetSrcObject(texture_id, stream_id, owner_tag, track_id);
+  result->Success();
+}
+
+void FlutterWebRTC::HandleVideoRendererSetOptions(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  int64_t texture_id = params.LongInt("textureId");
+  VideoRendererSetOptions(texture_id, params.map(), std::move(result));
+}
+
+void FlutterWebRTC::HandleVideoRendererGetStats(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  int64_t texture_id = params.LongInt("textureId");
+  VideoRendererGetStats(texture_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleVideoRendererGetPoolStats(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  VideoRendererGetPoolStats(std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateCompositeRenderer(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  CreateCompositeRenderer(params.map(), std::move(result));
+}
+
+void FlutterWebRTC::HandleStartSnapshotSampler(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  StartSnapshotSampler(params.map(), std::move(result));
+}
+
+void FlutterWebRTC::HandleSnapshotSamplerSetTracks(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  SnapshotSamplerSetTracks(findList(params.map(), "trackIds"),
+                           std::move(result));
+}
+
+void FlutterWebRTC::HandleStopSnapshotSampler(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  StopSnapshotSampler(std::move(result));
+}
+
+void FlutterWebRTC::HandleCompositeRendererSetLayout(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  int64_t texture_id = params.LongInt("textureId");
+  CompositeRendererSetLayout(texture_id, params.map(), std::move(result));
+}
+
+void FlutterWebRTC::HandleMediaStreamTrackSwitchCamera(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& track_id = params.String("trackId");
+  MediaStreamTrackSwitchCamera(track_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleSetVolume(const EncodableValue* arguments,
+                                    std::unique_ptr<MethodResultProxy> result) {
+}
+
+void FlutterWebRTC::HandleGetLocalDescription(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("GetLocalDescription",
+                  "GetLocalDescription() peerConnection is null");
+    return;
+  }
+
+  GetLocalDescription(pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetRemoteDescription(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("GetRemoteDescription",
+                  "GetRemoteDescription() peerConnection is null");
+    return;
+  }
+
+  GetRemoteDescription(pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleMediaStreamAddTrack(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const std::string& streamId = params.String("streamId");
+  const std::string& trackId = params.String("trackId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (stream == nullptr) {
+    result->Error("MediaStreamAddTrack",
+                  "MediaStreamAddTrack() stream is null");
+    return;
+  }
+
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (track == nullptr) {
+    result->Error("MediaStreamAddTrack",
+                  "MediaStreamAddTrack() track is null");
+    return;
+  }
+
+  MediaStreamAddTrack(stream, track, std::move(result));
+  std::string kind = track->kind().std_string();
+  for (int i = 0; i < renders_.size(); i++) {
+    FlutterVideoRenderer* renderer = renders_.at(i).get();
+    if (renderer->CheckMediaStream(streamId) && 0 == kind.compare("video")) {
+      renderer->SetVideoTrack(static_cast<RTCVideoTrack*>(track.get()));
     }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setLocalDescriptionFailed",
-                    "setLocalDescription() peerConnection is null");
-      return;
+  }
+}
+
+void FlutterWebRTC::HandleMediaStreamRemoveTrack(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const std::string& streamId = params.String("streamId");
+  const std::string& trackId = params.String("trackId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (stream == nullptr) {
+    result->Error("MediaStreamRemoveTrack",
+                  "MediaStreamRemoveTrack() stream is null");
+    return;
+  }
+
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (track == nullptr) {
+    result->Error("MediaStreamRemoveTrack",
+                  "MediaStreamRemoveTrack() track is null");
+    return;
+  }
+
+  MediaStreamRemoveTrack(stream, track, std::move(result));
+
+  for (int i = 0; i < renders_.size(); i++) {
+    FlutterVideoRenderer* renderer = renders_.at(i).get();
+    if (renderer->CheckVideoTrack(streamId)) {
+      renderer->SetVideoTrack(nullptr);
     }
+  }
+}
+
+void FlutterWebRTC::HandleAddTrack(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const std::string& trackId = params.String("trackId");
+  const EncodableList& streamIds = params.List("streamIds");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("AddTrack", "AddTrack() peerConnection is null");
+    return;
+  }
 
-    SdpParseError error;
-    scoped_refptr<RTCSessionDescription> description =
-        RTCSessionDescription::Create(findString(constraints, "type").c_str(),
-                                      findString(constraints, "sdp").c_str(),
-                                      &error);
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (track == nullptr) {
+    result->Error("AddTrack", "AddTrack() track is null");
+    return;
+  }
+  std::vector<std::string> ids;
+  for (const EncodableValue& value : streamIds) {
+    ids.push_back(GetValue<std::string>(value));
+  }
 
-    if (description.get() != nullptr) {
-      SetLocalDescription(description.get(), pc, std::move(result));
-    } else {
-      result->Error("setLocalDescriptionFailed", "Invalid type or sdp");
-    }
-  } else if (method_call.method_name().compare("setRemoteDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setRemoteDescriptionFailed",
-                    "setRemoteDescription() peerConnection is null");
-      return;
-    }
+  AddTrack(pc, track, ids, std::move(result));
+}
 
-    SdpParseError error;
-    scoped_refptr<RTCSessionDescription> description =
-        RTCSessionDescription::Create(findString(constraints, "type").c_str(),
-                                      findString(constraints, "sdp").c_str(),
-                                      &error);
+void FlutterWebRTC::HandleRemoveTrack(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
 
-    if (description.get() != nullptr) {
-      SetRemoteDescription(description.get(), pc, std::move(result));
-    } else {
-      result->Error("setRemoteDescriptionFailed", "Invalid type or sdp");
-    }
-  } else if (method_call.method_name().compare("addCandidate") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "candidate");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addCandidateFailed",
-                    "addCandidate() peerConnection is null");
-      return;
-    }
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const std::string& senderId = params.String("senderId");
 
-    SdpParseError error;
-    std::string candidate = findString(constraints, "candidate");
-    if (candidate.empty()) {
-      // received the end-of-candidates
-      result->Success();
-      return;
-    }
-    int sdpMLineIndex = findInt(constraints, "sdpMLineIndex");
-    scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
-        candidate.c_str(), findString(constraints, "sdpMid").c_str(),
-        sdpMLineIndex == -1 ? 0 : sdpMLineIndex, &error);
-
-    if (rtc_candidate.get() != nullptr) {
-      AddIceCandidate(rtc_candidate.get(), pc, std::move(result));
-    } else {
-      result->Error("addCandidateFailed", "Invalid candidate");
-    }
-  } else if (method_call.method_name().compare("getStats") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string track_id = findString(params, "trackId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getStatsFailed", "getStats() peerConnection is null");
-      return;
-    }
-    GetStats(track_id, pc, std::move(result));
-  } else if (method_call.method_name().compare("createDataChannel") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createDataChannelFailed",
-                    "createDataChannel() peerConnection is null");
-      return;
-    }
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("removeTrack", "removeTrack() peerConnection is null");
+    return;
+  }
 
-    const std::string label = findString(params, "label");
-    const EncodableMap dataChannelDict = findMap(params, "dataChannelDict");
+  RemoveTrack(pc, senderId, std::move(result));
+}
 
-    CreateDataChannel(peerConnectionId, label, dataChannelDict, pc,
-                      std::move(result));
-  } else if (method_call.method_name().compare("dataChannelSend") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelSendFailed",
-                    "dataChannelSend() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleAddTransceiver(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const ArgView transceiverInit = params.Map("transceiverInit");
+  const std::string& mediaType = params.String("mediaType");
+  const std::string& trackId = params.String("trackId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addTransceiver",
+                  "addTransceiver() peerConnection is null");
+    return;
+  }
+  AddTransceiver(pc, trackId, mediaType, transceiverInit.map(),
+                 std::move(result));
+}
 
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    const std::string type = findString(params, "type");
-    const EncodableValue data = findEncodableValue(params, "data");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelSendFailed",
-                    "dataChannelSend() data_channel is null");
-      return;
-    }
-    DataChannelSend(data_channel, type, data, std::move(result));
-  } else if (method_call.method_name().compare("dataChannelClose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelCloseFailed",
-                    "dataChannelClose() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetTransceivers(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getTransceivers",
+                  "getTransceivers() peerConnection is null");
+    return;
+  }
 
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelCloseFailed",
-                    "dataChannelClose() data_channel is null");
-      return;
-    }
-    DataChannelClose(data_channel, dataChannelId, std::move(result));
-  } else if (method_call.method_name().compare("streamDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string stream_id = findString(params, "streamId");
-    MediaStreamDispose(stream_id, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamTrackSetEnable") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    const EncodableValue enable = findEncodableValue(params, "enabled");
-    RTCMediaTrack* track = MediaTrackForId(track_id);
-    if (track != nullptr) {
-      track->set_enabled(GetValue<bool>(enable));
-    }
-    result->Success();
-  } else if (method_call.method_name().compare("trackDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    MediaStreamTrackDispose(track_id, std::move(result));
-  } else if (method_call.method_name().compare("restartIce") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("restartIceFailed", "restartIce() peerConnection is null");
-      return;
-    }
-    pc->RestartIce();
-    result->Success();
-  } else if (method_call.method_name().compare("peerConnectionClose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("peerConnectionCloseFailed",
-                    "peerConnectionClose() peerConnection is null");
-      return;
-    }
-    RTCPeerConnectionClose(pc, peerConnectionId, std::move(result));
-  } else if (method_call.method_name().compare("peerConnectionDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Success();
-      return;
-    }
-    RTCPeerConnectionDispose(pc, peerConnectionId, std::move(result));
-  } else if (method_call.method_name().compare("createVideoRenderer") == 0) {
-    CreateVideoRendererTexture(std::move(result));
-  } else if (method_call.method_name().compare("videoRendererDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    int64_t texture_id = findLongInt(params, "textureId");
-    VideoRendererDispose(texture_id, std::move(result));
-  } else if (method_call.method_name().compare("videoRendererSetSrcObject") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string stream_id = findString(params, "streamId");
-    int64_t texture_id = findLongInt(params, "textureId");
-    const std::string owner_tag = findString(params, "ownerTag");
-    const std::string track_id = findString(params, "trackId");
-
-    VideoRendererSetSrcObject(texture_id, stream_id, owner_tag, track_id);
-    result->Success();
-  } else if (method_call.method_name().compare(
-                 "mediaStreamTrackSwitchCamera") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    MediaStreamTrackSwitchCamera(track_id, std::move(result));
-  } else if (method_call.method_name().compare("setVolume") == 0) {
-  } else if (method_call.method_name().compare("getLocalDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("GetLocalDescription",
-                    "GetLocalDescription() peerConnection is null");
-      return;
-    }
+  GetTransceivers(pc, std::move(result));
+}
 
-    GetLocalDescription(pc, std::move(result));
-  } else if (method_call.method_name().compare("getRemoteDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("GetRemoteDescription",
-                    "GetRemoteDescription() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetReceivers(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
 
-    GetRemoteDescription(pc, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamAddTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getReceivers", "getReceivers() peerConnection is null");
+    return;
+  }
 
-    const std::string streamId = findString(params, "streamId");
-    const std::string trackId = findString(params, "trackId");
+  GetReceivers(pc, std::move(result));
+}
 
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (stream == nullptr) {
-      result->Error("MediaStreamAddTrack",
-                    "MediaStreamAddTrack() stream is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetSenders(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
 
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("MediaStreamAddTrack",
-                    "MediaStreamAddTrack() track is null");
-      return;
-    }
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getSenders", "getSenders() peerConnection is null");
+    return;
+  }
 
-    MediaStreamAddTrack(stream, track, std::move(result));
-    std::string kind = track->kind().std_string();
-    for (int i = 0; i < renders_.size(); i++) {
-      FlutterVideoRenderer* renderer = renders_.at(i).get();
-      if (renderer->CheckMediaStream(streamId) && 0 == kind.compare("video")) {
-        renderer->SetVideoTrack(static_cast<RTCVideoTrack*>(track.get()));
-      }
-    }
-  } else if (method_call.method_name().compare("mediaStreamRemoveTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  GetSenders(pc, std::move(result));
+}
 
-    const std::string streamId = findString(params, "streamId");
-    const std::string trackId = findString(params, "trackId");
+void FlutterWebRTC::HandleRtpSenderSetTrack(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderSetTrack",
+                  "rtpSenderSetTrack() peerConnection is null");
+    return;
+  }
 
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (stream == nullptr) {
-      result->Error("MediaStreamRemoveTrack",
-                    "MediaStreamRemoveTrack() stream is null");
-      return;
-    }
+  const std::string& trackId = params.String("trackId");
+  RTCMediaTrack* track = MediaTrackForId(trackId);
 
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("MediaStreamRemoveTrack",
-                    "MediaStreamRemoveTrack() track is null");
-      return;
-    }
+  const std::string& rtpSenderId = params.String("rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderSetTrack",
+                  "rtpSenderSetTrack() rtpSenderId is null or empty");
+    return;
+  }
+  RtpSenderSetTrack(pc, track, rtpSenderId, std::move(result));
+}
 
-    MediaStreamRemoveTrack(stream, track, std::move(result));
+void FlutterWebRTC::HandleRtpSenderSetStreams(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderSetStream",
+                  "rtpSenderSetStream() peerConnection is null");
+    return;
+  }
 
-    for (int i = 0; i < renders_.size(); i++) {
-      FlutterVideoRenderer* renderer = renders_.at(i).get();
-      if (renderer->CheckVideoTrack(streamId)) {
-        renderer->SetVideoTrack(nullptr);
-      }
-    }
-  } else if (method_call.method_name().compare("addTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  const EncodableList& encodableStreamIds = params.List("streamIds");
+  if (encodableStreamIds.empty()) {
+    result->Error("rtpSenderSetStream",
+                  "rtpSenderSetStream() streamId is null or empty");
+    return;
+  }
+  std::vector<std::string> streamIds{};
+  for (const EncodableValue& value : encodableStreamIds) {
+    streamIds.push_back(GetValue<std::string>(value));
+  }
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string trackId = findString(params, "trackId");
-    const EncodableList streamIds = findList(params, "streamIds");
+  const std::string& rtpSenderId = params.String("rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderSetStream",
+                  "rtpSenderSetStream() rtpSenderId is null or empty");
+    return;
+  }
+  RtpSenderSetStream(pc, streamIds, rtpSenderId, std::move(result));
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("AddTrack", "AddTrack() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleRtpSenderReplaceTrack(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderReplaceTrack",
+                  "rtpSenderReplaceTrack() peerConnection is null");
+    return;
+  }
 
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("AddTrack", "AddTrack() track is null");
-      return;
-    }
-    std::vector<std::string> ids;
-    for (EncodableValue value : streamIds) {
-      ids.push_back(GetValue<std::string>(value));
-    }
+  const std::string& trackId = params.String("trackId");
+  RTCMediaTrack* track = MediaTrackForId(trackId);
 
-    AddTrack(pc, track, ids, std::move(result));
+  const std::string& rtpSenderId = params.String("rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderReplaceTrack",
+                  "rtpSenderReplaceTrack() rtpSenderId is null or empty");
+    return;
+  }
+  RtpSenderReplaceTrack(pc, track, rtpSenderId, std::move(result));
+}
 
-  } else if (method_call.method_name().compare("removeTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleRtpSenderSetParameters(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderSetParameters",
+                  "rtpSenderSetParameters() peerConnection is null");
+    return;
+  }
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string senderId = findString(params, "senderId");
+  const std::string& rtpSenderId = params.String("rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderSetParameters",
+                  "rtpSenderSetParameters() rtpSenderId is null or empty");
+    return;
+  }
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("removeTrack", "removeTrack() peerConnection is null");
-      return;
-    }
+  const ArgView parameters = params.Map("parameters");
+  if (parameters.empty()) {
+    result->Error("rtpSenderSetParameters",
+                  "rtpSenderSetParameters() parameters is null or empty");
+    return;
+  }
 
-    RemoveTrack(pc, senderId, std::move(result));
+  RtpSenderSetParameters(pc, rtpSenderId, parameters.map(),
+                         std::move(result));
+}
 
-  } else if (method_call.method_name().compare("addTransceiver") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap transceiverInit = findMap(params, "transceiverInit");
-    const std::string mediaType = findString(params, "mediaType");
-    const std::string trackId = findString(params, "trackId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addTransceiver",
-                    "addTransceiver() peerConnection is null");
-      return;
-    }
-    AddTransceiver(pc, trackId, mediaType, transceiverInit, std::move(result));
-  } else if (method_call.method_name().compare("getTransceivers") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getTransceivers",
-                    "getTransceivers() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleRtpTransceiverStop(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpTransceiverStop",
+                  "rtpTransceiverStop() peerConnection is null");
+    return;
+  }
 
-    GetTransceivers(pc, std::move(result));
-  } else if (method_call.method_name().compare("getReceivers") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getReceivers", "getReceivers() peerConnection is null");
-      return;
-    }
+  const std::string& transceiverId = params.String("transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverStop",
+                  "rtpTransceiverStop() transceiverId is null or empty");
+    return;
+  }
 
-    GetReceivers(pc, std::move(result));
+  RtpTransceiverStop(pc, transceiverId, std::move(result));
+}
 
-  } else if (method_call.method_name().compare("getSenders") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getSenders", "getSenders() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleRtpTransceiverGetCurrentDirection(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error(
+        "rtpTransceiverGetCurrentDirection",
+        "rtpTransceiverGetCurrentDirection() peerConnection is null");
+    return;
+  }
 
-    GetSenders(pc, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetTrack",
-                    "rtpSenderSetTrack() peerConnection is null");
-      return;
-    }
+  const std::string& transceiverId = params.String("transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverGetCurrentDirection",
+                  "rtpTransceiverGetCurrentDirection() transceiverId is "
+                  "null or empty");
+    return;
+  }
 
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
+  RtpTransceiverGetCurrentDirection(pc, transceiverId, std::move(result));
+}
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetTrack",
-                    "rtpSenderSetTrack() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderSetTrack(pc, track, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetStreams") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleRtpTransceiverSetDirection(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpTransceiverSetDirection",
+                  "rtpTransceiverSetDirection() peerConnection is null");
+    return;
+  }
 
-    const EncodableList encodableStreamIds = findList(params, "streamIds");
-    if (encodableStreamIds.empty()) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() streamId is null or empty");
-      return;
-    }
-    std::vector<std::string> streamIds{};
-    for (EncodableValue value : encodableStreamIds) {
-      streamIds.push_back(GetValue<std::string>(value));
-    }
+  const std::string& transceiverId = params.String("transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverSetDirection",
+                  "rtpTransceiverSetDirection() transceiverId is "
+                  "null or empty");
+    return;
+  }
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderSetStream(pc, streamIds, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderReplaceTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderReplaceTrack",
-                    "rtpSenderReplaceTrack() peerConnection is null");
-      return;
-    }
+  const std::string& direction = params.String("direction");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverSetDirection",
+                  "rtpTransceiverSetDirection() direction is null or empty");
+    return;
+  }
 
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
+  RtpTransceiverSetDirection(pc, transceiverId, direction, std::move(result));
+}
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderReplaceTrack",
-                    "rtpSenderReplaceTrack() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderReplaceTrack(pc, track, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetParameters") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleSetConfiguration(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setConfiguration",
+                  "setConfiguration() peerConnection is null");
+    return;
+  }
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() rtpSenderId is null or empty");
-      return;
-    }
+  const ArgView configuration = params.Map("configuration");
+  if (configuration.empty()) {
+    result->Error("setConfiguration",
+                  "setConfiguration() configuration is null or empty");
+    return;
+  }
+  SetConfiguration(pc, configuration.map(), std::move(result));
+}
 
-    const EncodableMap parameters = findMap(params, "parameters");
-    if (0 == parameters.size()) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() parameters is null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleCaptureFrame(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
 
-    RtpSenderSetParameters(pc, rtpSenderId, parameters, std::move(result));
-  } else if (method_call.method_name().compare("rtpTransceiverStop") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpTransceiverStop",
-                    "rtpTransceiverStop() peerConnection is null");
-      return;
-    }
+  const std::string& trackId = params.String("trackId");
+  RTCMediaTrack* track = MediaTrackForId(trackId);
+  if (nullptr == track) {
+    result->Error("captureFrame", "captureFrame() track is null");
+    return;
+  }
+  std::string kind = track->kind().std_string();
+  if (0 != kind.compare("video")) {
+    result->Error("captureFrame", "captureFrame() track not is video track");
+    return;
+  }
+  // Without a path the image comes back in the result instead of a file.
+  FrameCaptureOptions options;
+  options.path = params.String("path");
+  const std::string& format = params.String("format");
+  if (format == "rgba") {
+    options.raw_rgba = true;
+  } else if (!format.empty() &&
+             !ImageFormatFromName(format, &options.encode.format)) {
+    result->Error("captureFrame",
+                  "captureFrame() unsupported format " + format);
+    return;
+  }
+  int quality = params.Int("quality");
+  if (quality > 0)
+    options.encode.quality = quality;
+  int timeout_ms = params.Int("timeoutMs");
+  if (timeout_ms > 0)
+    options.timeout = std::chrono::milliseconds(timeout_ms);
+  CaptureFrame(reinterpret_cast<RTCVideoTrack*>(track), options,
+               std::move(result));
+}
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverStop",
-                    "rtpTransceiverStop() transceiverId is null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleStartRecordToFile(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
 
-    RtpTransceiverStop(pc, transceiverId, std::move(result));
-  } else if (method_call.method_name().compare(
-                 "rtpTransceiverGetCurrentDirection") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error(
-          "rtpTransceiverGetCurrentDirection",
-          "rtpTransceiverGetCurrentDirection() peerConnection is null");
-      return;
-    }
+  const std::string& path = params.String("path");
+  if (path.empty()) {
+    result->Error("startRecordToFile",
+                  "startRecordToFile() path is null or empty");
+    return;
+  }
+  // Only video is recorded on desktop; Y4M has no audio.
+  const std::string& trackId = params.String("videoTrackId");
+  RTCMediaTrack* track = MediaTrackForId(trackId);
+  if (nullptr == track || track->kind().std_string() != "video") {
+    result->Error("startRecordToFile",
+                  "startRecordToFile() needs a video track");
+    return;
+  }
+  StartRecordToFile(path, params.LongInt("recorderId"),
+                    reinterpret_cast<RTCVideoTrack*>(track),
+                    std::move(result));
+}
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverGetCurrentDirection",
-                    "rtpTransceiverGetCurrentDirection() transceiverId is "
-                    "null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleStopRecordToFile(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  StopRecordToFile(params.LongInt("recorderId"), std::move(result));
+}
 
-    RtpTransceiverGetCurrentDirection(pc, transceiverId, std::move(result));
-  } else if (method_call.method_name().compare("rtpTransceiverSetDirection") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleCreateLocalMediaStream(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  CreateLocalMediaStream(std::move(result));
+}
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() transceiverId is "
-                    "null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleCanInsertDtmf(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const std::string& rtpSenderId = params.String("rtpSenderId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("canInsertDtmf", "canInsertDtmf() peerConnection is null");
+    return;
+  }
 
-    const std::string direction = findString(params, "direction");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() direction is null or empty");
-      return;
-    }
+  auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
 
-    RtpTransceiverSetDirection(pc, transceiverId, direction, std::move(result));
-  } else if (method_call.method_name().compare("setConfiguration") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setConfiguration",
-                    "setConfiguration() peerConnection is null");
-      return;
-    }
+  if (rtpSender == nullptr) {
+    result->Error("sendDtmf", "sendDtmf() rtpSender is null");
+    return;
+  }
+  auto dtmfSender = rtpSender->dtmf_sender();
+  bool canInsertDtmf = dtmfSender->CanInsertDtmf();
 
-    const EncodableMap configuration = findMap(params, "configuration");
-    if (configuration.empty()) {
-      result->Error("setConfiguration",
-                    "setConfiguration() configuration is null or empty");
-      return;
-    }
-    SetConfiguration(pc, configuration, std::move(result));
-  } else if (method_call.method_name().compare("captureFrame") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  result->Success(EncodableValue(canInsertDtmf));
+}
 
-    const std::string path = findString(params, "path");
-    if (path.empty()) {
-      result->Error("captureFrame", "captureFrame() path is null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleSendDtmf(const EncodableValue* arguments,
+                                   std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  const std::string& rtpSenderId = params.String("rtpSenderId");
+  const std::string& tone = params.String("tone");
+  int duration = params.Int("duration");
+  int gap = params.Int("gap");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("sendDtmf", "sendDtmf() peerConnection is null");
+    return;
+  }
 
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
-    if (nullptr == track) {
-      result->Error("captureFrame", "captureFrame() track is null");
-      return;
-    }
-    std::string kind = track->kind().std_string();
-    if (0 != kind.compare("video")) {
-      result->Error("captureFrame", "captureFrame() track not is video track");
-      return;
-    }
-    CaptureFrame(reinterpret_cast<RTCVideoTrack*>(track), path,
-                 std::move(result));
+  auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
 
-  } else if (method_call.method_name().compare("createLocalMediaStream") == 0) {
-    CreateLocalMediaStream(std::move(result));
-  } else if (method_call.method_name().compare("canInsertDtmf") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("canInsertDtmf", "canInsertDtmf() peerConnection is null");
-      return;
-    }
+  if (rtpSender == nullptr) {
+    result->Error("sendDtmf", "sendDtmf() rtpSender is null");
+    return;
+  }
 
-    auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
+  auto dtmfSender = rtpSender->dtmf_sender();
+  dtmfSender->InsertDtmf(tone, duration, gap);
 
-    if (rtpSender == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() rtpSender is null");
-      return;
-    }
-    auto dtmfSender = rtpSender->dtmf_sender();
-    bool canInsertDtmf = dtmfSender->CanInsertDtmf();
-
-    result->Success(EncodableValue(canInsertDtmf));
-  } else if (method_call.method_name().compare("sendDtmf") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    const std::string tone = findString(params, "tone");
-    int duration = findInt(params, "duration");
-    int gap = findInt(params, "gap");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() peerConnection is null");
-      return;
-    }
+  result->Success();
+}
 
-    auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
+void FlutterWebRTC::HandleGetRtpSenderCapabilities(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  RTCMediaType mediaType = RTCMediaType::AUDIO;
+  const std::string& kind = params.String("kind");
+  if (0 == kind.compare("video")) {
+    mediaType = RTCMediaType::VIDEO;
+  } else if (0 == kind.compare("audio")) {
+    mediaType = RTCMediaType::AUDIO;
+  } else {
+    result->Error("getRtpSenderCapabilities",
+                  "getRtpSenderCapabilities() kind is null or empty");
+    return;
+  }
+  auto capabilities = factory_->GetRtpSenderCapabilities(mediaType);
+  EncodableMap map;
+  EncodableList codecsList;
+  for (auto codec : capabilities->codecs().std_vector()) {
+    EncodableMap codecMap;
+    codecMap[EncodableValue("mimeType")] =
+        EncodableValue(codec->mime_type().std_string());
+    codecMap[EncodableValue("clockRate")] =
+        EncodableValue(codec->clock_rate());
+    codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
+    codecMap[EncodableValue("sdpFmtpLine")] =
+        EncodableValue(codec->sdp_fmtp_line().std_string());
+    codecsList.push_back(EncodableValue(codecMap));
+  }
+  map[EncodableValue("codecs")] = EncodableValue(codecsList);
+  map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
+  map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
 
-    if (rtpSender == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() rtpSender is null");
-      return;
-    }
+  result->Success(EncodableValue(map));
+}
 
-    auto dtmfSender = rtpSender->dtmf_sender();
-    dtmfSender->InsertDtmf(tone, duration, gap);
+void FlutterWebRTC::HandleGetRtpReceiverCapabilities(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  const ArgView params(arguments);
+
+  RTCMediaType mediaType = RTCMediaType::AUDIO;
+  const std::string& kind = params.String("kind");
+  if (0 == kind.compare("video")) {
+    mediaType = RTCMediaType::VIDEO;
+  } else if (0 == kind.compare("audio")) {
+    mediaType = RTCMediaType::AUDIO;
+  } else {
+    result->Error("getRtpSenderCapabilities",
+                  "getRtpSenderCapabilities() kind is null or empty");
+    return;
+  }
+  auto capabilities = factory_->GetRtpReceiverCapabilities(mediaType);
+  EncodableMap map;
+  EncodableList codecsList;
+  for (auto codec : capabilities->codecs().std_vector()) {
+    EncodableMap codecMap;
+    codecMap[EncodableValue("mimeType")] =
+        EncodableValue(codec->mime_type().std_string());
+    codecMap[EncodableValue("clockRate")] =
+        EncodableValue(codec->clock_rate());
+    codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
+    codecMap[EncodableValue("sdpFmtpLine")] =
+        EncodableValue(codec->sdp_fmtp_line().std_string());
+    codecsList.push_back(EncodableValue(codecMap));
+  }
+  map[EncodableValue("codecs")] = EncodableValue(codecsList);
+  map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
+  map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
 
-    result->Success();
-  } else if (method_call.method_name().compare("getRtpSenderCapabilities") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    RTCMediaType mediaType = RTCMediaType::AUDIO;
-    const std::string kind = findString(params, "kind");
-    if (0 == kind.compare("video")) {
-      mediaType = RTCMediaType::VIDEO;
-    } else if (0 == kind.compare("audio")) {
-      mediaType = RTCMediaType::AUDIO;
-    } else {
-      result->Error("getRtpSenderCapabilities",
-                    "getRtpSenderCapabilities() kind is null or empty");
-      return;
-    }
-    auto capabilities = factory_->GetRtpSenderCapabilities(mediaType);
-    EncodableMap map;
-    EncodableList codecsList;
-    for (auto codec : capabilities->codecs().std_vector()) {
-      EncodableMap codecMap;
-      codecMap[EncodableValue("mimeType")] =
-          EncodableValue(codec->mime_type().std_string());
-      codecMap[EncodableValue("clockRate")] =
-          EncodableValue(codec->clock_rate());
-      codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
-      codecMap[EncodableValue("sdpFmtpLine")] =
-          EncodableValue(codec->sdp_fmtp_line().std_string());
-      codecsList.push_back(EncodableValue(codecMap));
-    }
-    map[EncodableValue("codecs")] = EncodableValue(codecsList);
-    map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
-    map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
-
-    result->Success(EncodableValue(map));
-  } else if (method_call.method_name().compare("getRtpReceiverCapabilities") ==
-             0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    RTCMediaType mediaType = RTCMediaType::AUDIO;
-    const std::string kind = findString(params, "kind");
-    if (0 == kind.compare("video")) {
-      mediaType = RTCMediaType::VIDEO;
-    } else if (0 == kind.compare("audio")) {
-      mediaType = RTCMediaType::AUDIO;
-    } else {
-      result->Error("getRtpSenderCapabilities",
-                    "getRtpSenderCapabilities() kind is null or empty");
-      return;
-    }
-    auto capabilities = factory_->GetRtpReceiverCapabilities(mediaType);
-    EncodableMap map;
-    EncodableList codecsList;
-    for (auto codec : capabilities->codecs().std_vector()) {
-      EncodableMap codecMap;
-      codecMap[EncodableValue("mimeType")] =
-          EncodableValue(codec->mime_type().std_string());
-      codecMap[EncodableValue("clockRate")] =
-          EncodableValue(codec->clock_rate());
-      codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
-      codecMap[EncodableValue("sdpFmtpLine")] =
-          EncodableValue(codec->sdp_fmtp_line().std_string());
-      codecsList.push_back(EncodableValue(codecMap));
-    }
-    map[EncodableValue("codecs")] = EncodableValue(codecsList);
-    map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
-    map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
-
-    result->Success(EncodableValue(map));
-  } else if (method_call.method_name().compare("setCodecPreferences") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setCodecPreferences",
-                    "setCodecPreferences() peerConnection is null");
-      return;
-    }
+  result->Success(EncodableValue(map));
+}
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("setCodecPreferences",
-                    "setCodecPreferences() transceiverId is null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleSetCodecPreferences(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setCodecPreferences",
+                  "setCodecPreferences() peerConnection is null");
+    return;
+  }
 
-    const EncodableList codecs = findList(params, "codecs");
-    if (codecs.empty()) {
-      result->Error("Bad Arguments", "Codecs is required");
-      return;
-    }
-    RtpTransceiverSetCodecPreferences(pc, transceiverId, codecs,
-                                      std::move(result));
-  } else if (method_call.method_name().compare("getSignalingState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  const std::string& transceiverId = params.String("transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("setCodecPreferences",
+                  "setCodecPreferences() transceiverId is null or empty");
+    return;
+  }
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableList& codecs = params.List("codecs");
+  if (codecs.empty()) {
+    result->Error("Bad Arguments", "Codecs is required");
+    return;
+  }
+  RtpTransceiverSetCodecPreferences(pc, transceiverId, codecs,
+                                    std::move(result));
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getSignalingState",
-                    "getSignalingState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        signalingStateString(pc->signaling_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getIceGatheringState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleGetSignalingState(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string& peerConnectionId = params.String("peerConnectionId");
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getIceGatheringState",
-                    "getIceGatheringState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        iceGatheringStateString(pc->ice_gathering_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getIceConnectionState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getSignalingState",
+                  "getSignalingState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      signalingStateString(pc->signaling_state());
+  result->Success(EncodableValue(state));
+}
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+void FlutterWebRTC::HandleGetIceGatheringState(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getIceConnectionState",
-                    "getIceConnectionState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        iceConnectionStateString(pc->ice_connection_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getConnectionState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  const std::string& peerConnectionId = params.String("peerConnectionId");
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getIceGatheringState",
+                  "getIceGatheringState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      iceGatheringStateString(pc->ice_gathering_state());
+  result->Success(EncodableValue(state));
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getConnectionState",
-                    "getConnectionState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        peerConnectionStateString(pc->peer_connection_state());
-    result->Success(EncodableValue(state));
-  } else if (HandleFrameCryptorMethodCall(method_call, std::move(result))) {
-    // Do nothing
-  } else {
-    result->NotImplemented();
+void FlutterWebRTC::HandleGetIceConnectionState(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
   }
+  const ArgView params(arguments);
+
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getIceConnectionState",
+                  "getIceConnectionState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      iceConnectionStateString(pc->ice_connection_state());
+  result->Success(EncodableValue(state));
+}
+
+void FlutterWebRTC::HandleGetConnectionState(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+
+  const std::string& peerConnectionId = params.String("peerConnectionId");
+
+  RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getConnectionState",
+                  "getConnectionState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      peerConnectionStateString(pc->peer_connection_state());
+  result->Success(EncodableValue(state));
+}
+
+void FlutterWebRTC::HandleExecuteBatch(
+    const EncodableValue* arguments,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!arguments) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const ArgView params(arguments);
+  const EncodableList& operations = params.List("operations");
+  if (operations.empty()) {
+    result->Success(EncodableValue(EncodableList()));
+    return;
+  }
+
+  // The operation list is copied once: asynchronous handlers may resume the
+  // batch after the platform message that carried it has been released.
+  auto batch = std::make_shared<MethodBatch>(
+      operations, params.Boolean("stopOnError"),
+      [this](const std::string& method_name, const EncodableValue* arguments,
+             std::unique_ptr<MethodResultProxy> result) {
+        Dispatch(method_name, arguments, std::move(result));
+      },
+      std::move(result));
+  batch->Run();
 }
 
 }  // namespace flutter_webrtc_plugin
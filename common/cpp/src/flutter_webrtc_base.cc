@@ -128,10 +128,10 @@ void FlutterWebRTCBase::ParseConstraints(
     const EncodableMap& src,
     scoped_refptr<RTCMediaConstraints> mediaConstraints,
     ParseConstraintType type /*= kMandatory*/) {
-  for (auto kv : src) {
-    EncodableValue k = kv.first;
-    EncodableValue v = kv.second;
-    std::string key = GetValue<std::string>(k);
+  for (const auto& kv : src) {
+    const EncodableValue& k = kv.first;
+    const EncodableValue& v = kv.second;
+    const std::string& key = GetValue<std::string>(k);
     std::string value;
     if (TypeIs<EncodableList>(v) || TypeIs<EncodableMap>(v)) {
     } else if (TypeIs<std::string>(v)) {
@@ -164,22 +164,20 @@ scoped_refptr<RTCMediaConstraints> FlutterWebRTCBase::ParseMediaConstraints(
   scoped_refptr<RTCMediaConstraints> media_constraints =
       RTCMediaConstraints::Create();
 
-  if (constraints.find(EncodableValue("mandatory")) != constraints.end()) {
-    auto it = constraints.find(EncodableValue("mandatory"));
-    const EncodableMap mandatory = GetValue<EncodableMap>(it->second);
-    ParseConstraints(mandatory, media_constraints, kMandatory);
+  const EncodableMap* mandatory = findMapRef(constraints, "mandatory");
+  if (mandatory != nullptr) {
+    ParseConstraints(*mandatory, media_constraints, kMandatory);
   } else {
     // Log.d(TAG, "mandatory constraints are not a map");
   }
 
-  auto it = constraints.find(EncodableValue("optional"));
-  if (it != constraints.end()) {
-    const EncodableValue optional = it->second;
-    if (TypeIs<EncodableMap>(optional)) {
-      ParseConstraints(GetValue<EncodableMap>(optional), media_constraints,
+  const EncodableValue* optional = findValueRef(constraints, "optional");
+  if (optional != nullptr) {
+    if (TypeIs<EncodableMap>(*optional)) {
+      ParseConstraints(GetValue<EncodableMap>(*optional), media_constraints,
                        kOptional);
-    } else if (TypeIs<EncodableList>(optional)) {
-      const EncodableList list = GetValue<EncodableList>(optional);
+    } else if (TypeIs<EncodableList>(*optional)) {
+      const EncodableList& list = GetValue<EncodableList>(*optional);
       for (size_t i = 0; i < list.size(); i++) {
         ParseConstraints(GetValue<EncodableMap>(list[i]), media_constraints,
                          kOptional);
@@ -197,7 +195,8 @@ bool FlutterWebRTCBase::CreateIceServers(const EncodableList& iceServersArray,
   size_t size = iceServersArray.size();
   for (size_t i = 0; i < size; i++) {
     IceServer& ice_server = ice_servers[i];
-    EncodableMap iceServerMap = GetValue<EncodableMap>(iceServersArray[i]);
+    const EncodableMap& iceServerMap =
+        GetValue<EncodableMap>(iceServersArray[i]);
 
     if (iceServerMap.find(EncodableValue("username")) != iceServerMap.end()) {
       ice_server.username = GetValue<std::string>(
@@ -218,10 +217,10 @@ bool FlutterWebRTCBase::CreateIceServers(const EncodableList& iceServersArray,
         ice_server.uri = GetValue<std::string>(it->second);
       }
       if (TypeIs<EncodableList>(it->second)) {
-        const EncodableList urls = GetValue<EncodableList>(it->second);
-        for (auto url : urls) {
+        const EncodableList& urls = GetValue<EncodableList>(it->second);
+        for (const auto& url : urls) {
           if (TypeIs<EncodableMap>(url)) {
-            const EncodableMap map = GetValue<EncodableMap>(url);
+            const EncodableMap& map = GetValue<EncodableMap>(url);
             std::string value;
             auto it2 = map.find(EncodableValue("url"));
             if (it2 != map.end()) {
@@ -241,13 +240,14 @@ bool FlutterWebRTCBase::ParseRTCConfiguration(const EncodableMap& map,
                                               RTCConfiguration& conf) {
   auto it = map.find(EncodableValue("iceServers"));
   if (it != map.end()) {
-    const EncodableList iceServersArray = GetValue<EncodableList>(it->second);
+    const EncodableList& iceServersArray =
+        GetValue<EncodableList>(it->second);
     CreateIceServers(iceServersArray, conf.ice_servers);
   }
   // iceTransportPolicy (public API)
   it = map.find(EncodableValue("iceTransportPolicy"));
   if (it != map.end() && TypeIs<std::string>(it->second)) {
-    std::string v = GetValue<std::string>(it->second);
+    const std::string& v = GetValue<std::string>(it->second);
     if (v == "all")  // public
       conf.type = IceTransportsType::kAll;
     else if (v == "relay")
@@ -261,7 +261,7 @@ bool FlutterWebRTCBase::ParseRTCConfiguration(const EncodableMap& map,
   // bundlePolicy (public api)
   it = map.find(EncodableValue("bundlePolicy"));
   if (it != map.end() && TypeIs<std::string>(it->second)) {
-    std::string v = GetValue<std::string>(it->second);
+    const std::string& v = GetValue<std::string>(it->second);
     if (v == "balanced")  // public
       conf.bundle_policy = kBundlePolicyBalanced;
     else if (v == "max-compat")  // public
@@ -273,7 +273,7 @@ bool FlutterWebRTCBase::ParseRTCConfiguration(const EncodableMap& map,
   // rtcpMuxPolicy (public api)
   it = map.find(EncodableValue("rtcpMuxPolicy"));
   if (it != map.end() && TypeIs<std::string>(it->second)) {
-    std::string v = GetValue<std::string>(it->second);
+    const std::string& v = GetValue<std::string>(it->second);
     if (v == "negotiate")  // public
       conf.rtcp_mux_policy = RtcpMuxPolicy::kRtcpMuxPolicyNegotiate;
     else if (v == "require")  // public
@@ -291,7 +291,7 @@ bool FlutterWebRTCBase::ParseRTCConfiguration(const EncodableMap& map,
   // sdpSemantics (public api)
   it = map.find(EncodableValue("sdpSemantics"));
   if (it != map.end() && TypeIs<std::string>(it->second)) {
-    std::string v = GetValue<std::string>(it->second);
+    const std::string& v = GetValue<std::string>(it->second);
     if (v == "plan-b")  // public
       conf.sdp_semantics = SdpSemantics::kPlanB;
     else if (v == "unified-plan")  // public
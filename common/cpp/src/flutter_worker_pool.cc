@@ -0,0 +1,111 @@
+#include "flutter_worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+constexpr size_t kMaxSharedWorkers = 4;
+
+// Shared between ParallelFor and the helpers it posts, which may still be
+// queued when the call returns.
+struct ParallelForState {
+  const std::function<void(size_t)>* fn = nullptr;
+  size_t count = 0;
+  std::atomic<size_t> next{0};
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t done = 0;
+};
+
+// Claims indices until none are left. |fn| is only touched for claimed
+// indices, all of which finish before ParallelFor returns.
+void DrainParallelFor(ParallelForState* state) {
+  size_t finished = 0;
+  for (size_t i = state->next++; i < state->count; i = state->next++) {
+    (*state->fn)(i);
+    finished++;
+  }
+  if (finished == 0)
+    return;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->done += finished;
+  if (state->done == state->count)
+    state->cv.notify_one();
+}
+
+}  // namespace
+
+WorkerPool* WorkerPool::Shared() {
+  static WorkerPool* pool = new WorkerPool(std::min<size_t>(
+      kMaxSharedWorkers,
+      std::max<size_t>(1, std::thread::hardware_concurrency()) - 1));
+  return pool;
+}
+
+WorkerPool::WorkerPool(size_t threads) {
+  threads = std::max<size_t>(1, threads);
+  for (size_t i = 0; i < threads; i++) {
+    threads_.emplace_back(&WorkerPool::Run, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Post(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void WorkerPool::ParallelFor(size_t count,
+                             const std::function<void(size_t)>& fn) {
+  if (count == 0)
+    return;
+  if (count == 1) {
+    fn(0);
+    return;
+  }
+  auto state = std::make_shared<ParallelForState>();
+  state->fn = &fn;
+  state->count = count;
+  size_t helpers = std::min(count - 1, threads_.size());
+  for (size_t i = 0; i < helpers; i++) {
+    Post([state] { DrainParallelFor(state.get()); });
+  }
+  // The caller works too, so progress never depends on a free worker.
+  DrainParallelFor(state.get());
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->cv.wait(lock, [&] { return state->done == state->count; });
+}
+
+void WorkerPool::Run() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty())
+        return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace flutter_webrtc_plugin
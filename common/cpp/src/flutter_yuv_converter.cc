@@ -0,0 +1,753 @@
+#include "flutter_yuv_converter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "flutter_worker_pool.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define FLUTTER_WEBRTC_YUV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FLUTTER_WEBRTC_YUV_NEON 1
+#include <arm_neon.h>
+#endif
+
+// MSVC exposes every intrinsic unconditionally; GCC and Clang need the
+// instruction set enabled on the function that uses it.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define FLUTTER_WEBRTC_TARGET_SSE2
+#define FLUTTER_WEBRTC_TARGET_AVX2
+#else
+#define FLUTTER_WEBRTC_TARGET_SSE2 __attribute__((target("sse2")))
+#define FLUTTER_WEBRTC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace flutter_webrtc_plugin {
+
+namespace {
+
+// libyuv's BT.601 limited-range constants, in 6-bit fixed point:
+//   R = 1.164 * (Y - 16) + 1.596 * V'
+//   G = 1.164 * (Y - 16) - 0.391 * U' - 0.813 * V'
+//   B = 1.164 * (Y - 16) + 2.018 * U'
+// with U' = U - 128, V' = V - 128. UB is capped at 128 as libyuv does.
+constexpr int kUB = 128;
+constexpr int kUG = 25;
+constexpr int kVG = 52;
+constexpr int kVR = 102;
+constexpr int kYG = 18997;
+constexpr int kYB = -1160;
+
+typedef void (*ConvertRowFunc)(const uint8_t* y,
+                               const uint8_t* u,
+                               const uint8_t* v,
+                               uint8_t* dst,
+                               int width,
+                               bool bgra);
+
+inline uint8_t Clamp255(int32_t value) {
+  return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+void ConvertRowScalar(const uint8_t* y,
+                      const uint8_t* u,
+                      const uint8_t* v,
+                      uint8_t* dst,
+                      int width,
+                      bool bgra) {
+  const int r_offset = bgra ? 2 : 0;
+  const int b_offset = bgra ? 0 : 2;
+  for (int x = 0; x < width; x++) {
+    int32_t y1 = static_cast<int32_t>(
+        (static_cast<uint32_t>(y[x]) * 0x0101 * kYG) >> 16);
+    int32_t u1 = u[x / 2] - 128;
+    int32_t v1 = v[x / 2] - 128;
+    dst[r_offset] = Clamp255((y1 + kVR * v1 + kYB) >> 6);
+    dst[1] = Clamp255((y1 - kUG * u1 - kVG * v1 + kYB) >> 6);
+    dst[b_offset] = Clamp255((y1 + kUB * u1 + kYB) >> 6);
+    dst[3] = 255;
+    dst += 4;
+  }
+}
+
+#if defined(FLUTTER_WEBRTC_YUV_X86)
+
+// The fixed-point math is done in 32-bit lanes; 16-bit lanes would need
+// libyuv's saturation tricks to stay exact.
+FLUTTER_WEBRTC_TARGET_SSE2 inline __m128i ChannelSSE2(__m128i y_lo,
+                                                      __m128i y_hi,
+                                                      __m128i uv_lo,
+                                                      __m128i uv_hi,
+                                                      __m128i coeff) {
+  __m128i lo = _mm_srai_epi32(_mm_add_epi32(y_lo, _mm_madd_epi16(uv_lo, coeff)),
+                              6);
+  __m128i hi = _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_madd_epi16(uv_hi, coeff)),
+                              6);
+  __m128i packed = _mm_packs_epi32(lo, hi);
+  return _mm_packus_epi16(packed, packed);
+}
+
+// 8 pixels per iteration.
+FLUTTER_WEBRTC_TARGET_SSE2 void ConvertRowSSE2(const uint8_t* y,
+                                               const uint8_t* u,
+                                               const uint8_t* v,
+                                               uint8_t* dst,
+                                               int width,
+                                               bool bgra) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i yg = _mm_set1_epi16(kYG);
+  const __m128i yb = _mm_set1_epi32(kYB);
+  const __m128i uv_bias = _mm_set1_epi16(128);
+  const __m128i alpha = _mm_set1_epi8(-1);
+  // Coefficients for interleaved (U', V') pairs fed to pmaddwd.
+  const __m128i coeff_b = _mm_setr_epi16(kUB, 0, kUB, 0, kUB, 0, kUB, 0);
+  const __m128i coeff_g =
+      _mm_setr_epi16(-kUG, -kVG, -kUG, -kVG, -kUG, -kVG, -kUG, -kVG);
+  const __m128i coeff_r = _mm_setr_epi16(0, kVR, 0, kVR, 0, kVR, 0, kVR);
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i y16 = _mm_unpacklo_epi8(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero);
+    __m128i y1 =
+        _mm_mulhi_epu16(_mm_or_si128(y16, _mm_slli_epi16(y16, 8)), yg);
+    __m128i y_lo = _mm_add_epi32(_mm_unpacklo_epi16(y1, zero), yb);
+    __m128i y_hi = _mm_add_epi32(_mm_unpackhi_epi16(y1, zero), yb);
+
+    int32_t u4, v4;
+    memcpy(&u4, u + x / 2, 4);
+    memcpy(&v4, v + x / 2, 4);
+    __m128i u8 = _mm_cvtsi32_si128(u4);
+    __m128i v8 = _mm_cvtsi32_si128(v4);
+    __m128i u16 = _mm_sub_epi16(
+        _mm_unpacklo_epi8(_mm_unpacklo_epi8(u8, u8), zero), uv_bias);
+    __m128i v16 = _mm_sub_epi16(
+        _mm_unpacklo_epi8(_mm_unpacklo_epi8(v8, v8), zero), uv_bias);
+    __m128i uv_lo = _mm_unpacklo_epi16(u16, v16);
+    __m128i uv_hi = _mm_unpackhi_epi16(u16, v16);
+
+    __m128i b8 = ChannelSSE2(y_lo, y_hi, uv_lo, uv_hi, coeff_b);
+    __m128i g8 = ChannelSSE2(y_lo, y_hi, uv_lo, uv_hi, coeff_g);
+    __m128i r8 = ChannelSSE2(y_lo, y_hi, uv_lo, uv_hi, coeff_r);
+    __m128i first = bgra ? b8 : r8;
+    __m128i third = bgra ? r8 : b8;
+
+    __m128i rg = _mm_unpacklo_epi8(first, g8);
+    __m128i ba = _mm_unpacklo_epi8(third, alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4),
+                     _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4 + 16),
+                     _mm_unpackhi_epi16(rg, ba));
+  }
+  ConvertRowScalar(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, bgra);
+}
+
+FLUTTER_WEBRTC_TARGET_AVX2 inline __m256i ChannelAVX2(__m256i y_lo,
+                                                      __m256i y_hi,
+                                                      __m256i uv_lo,
+                                                      __m256i uv_hi,
+                                                      __m256i coeff) {
+  __m256i lo = _mm256_srai_epi32(
+      _mm256_add_epi32(y_lo, _mm256_madd_epi16(uv_lo, coeff)), 6);
+  __m256i hi = _mm256_srai_epi32(
+      _mm256_add_epi32(y_hi, _mm256_madd_epi16(uv_hi, coeff)), 6);
+  __m256i packed = _mm256_packs_epi32(lo, hi);
+  return _mm256_packus_epi16(packed, packed);
+}
+
+// 16 pixels per iteration. The in-lane unpack/pack steps keep pixels 0-7 in
+// the low 128-bit lane and 8-15 in the high one until the final permute.
+FLUTTER_WEBRTC_TARGET_AVX2 void ConvertRowAVX2(const uint8_t* y,
+                                               const uint8_t* u,
+                                               const uint8_t* v,
+                                               uint8_t* dst,
+                                               int width,
+                                               bool bgra) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i yg = _mm256_set1_epi16(kYG);
+  const __m256i yb = _mm256_set1_epi32(kYB);
+  const __m256i uv_bias = _mm256_set1_epi16(128);
+  const __m256i alpha = _mm256_set1_epi8(-1);
+  const __m256i coeff_b = _mm256_broadcastsi128_si256(
+      _mm_setr_epi16(kUB, 0, kUB, 0, kUB, 0, kUB, 0));
+  const __m256i coeff_g = _mm256_broadcastsi128_si256(
+      _mm_setr_epi16(-kUG, -kVG, -kUG, -kVG, -kUG, -kVG, -kUG, -kVG));
+  const __m256i coeff_r = _mm256_broadcastsi128_si256(
+      _mm_setr_epi16(0, kVR, 0, kVR, 0, kVR, 0, kVR));
+
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    __m256i y16 = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x)));
+    __m256i y1 = _mm256_mulhi_epu16(
+        _mm256_or_si256(y16, _mm256_slli_epi16(y16, 8)), yg);
+    __m256i y_lo = _mm256_add_epi32(_mm256_unpacklo_epi16(y1, zero), yb);
+    __m256i y_hi = _mm256_add_epi32(_mm256_unpackhi_epi16(y1, zero), yb);
+
+    __m128i u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2));
+    __m128i v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2));
+    __m256i u16 = _mm256_sub_epi16(
+        _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u8, u8)), uv_bias);
+    __m256i v16 = _mm256_sub_epi16(
+        _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v8, v8)), uv_bias);
+    __m256i uv_lo = _mm256_unpacklo_epi16(u16, v16);
+    __m256i uv_hi = _mm256_unpackhi_epi16(u16, v16);
+
+    __m256i b8 = ChannelAVX2(y_lo, y_hi, uv_lo, uv_hi, coeff_b);
+    __m256i g8 = ChannelAVX2(y_lo, y_hi, uv_lo, uv_hi, coeff_g);
+    __m256i r8 = ChannelAVX2(y_lo, y_hi, uv_lo, uv_hi, coeff_r);
+    __m256i first = bgra ? b8 : r8;
+    __m256i third = bgra ? r8 : b8;
+
+    __m256i rg = _mm256_unpacklo_epi8(first, g8);
+    __m256i ba = _mm256_unpacklo_epi8(third, alpha);
+    __m256i lo = _mm256_unpacklo_epi16(rg, ba);
+    __m256i hi = _mm256_unpackhi_epi16(rg, ba);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4 + 32),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  ConvertRowSSE2(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, bgra);
+}
+
+bool CpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+  return true;
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[3] & (1 << 26)) != 0;
+#else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  return (edx & (1u << 26)) != 0;
+#endif
+}
+
+bool CpuHasAvx2() {
+  // AVX2 needs the CPU flag and the OS saving YMM state (OSXSAVE + XCR0).
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+    return false;
+  if ((_xgetbv(0) & 0x6) != 0x6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (__get_cpuid_max(0, nullptr) < 7)
+    return false;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  if ((ecx & (1u << 27)) == 0 || (ecx & (1u << 28)) == 0)
+    return false;
+  unsigned int xcr0_lo, xcr0_hi;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  if ((xcr0_lo & 0x6) != 0x6)
+    return false;
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return false;
+  return (ebx & (1u << 5)) != 0;
+#endif
+}
+
+#endif  // FLUTTER_WEBRTC_YUV_X86
+
+#if defined(FLUTTER_WEBRTC_YUV_NEON)
+
+inline uint8x8_t NarrowNEON(int32x4_t lo, int32x4_t hi) {
+  return vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 6)),
+                                  vqmovn_s32(vshrq_n_s32(hi, 6))));
+}
+
+// 8 pixels per iteration.
+void ConvertRowNEON(const uint8_t* y,
+                    const uint8_t* u,
+                    const uint8_t* v,
+                    uint8_t* dst,
+                    int width,
+                    bool bgra) {
+  const int32x4_t yb = vdupq_n_s32(kYB);
+  const int16x8_t uv_bias = vdupq_n_s16(128);
+
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    uint16x8_t y16 = vmovl_u8(vld1_u8(y + x));
+    y16 = vorrq_u16(y16, vshlq_n_u16(y16, 8));
+    int32x4_t y_lo = vaddq_s32(
+        vreinterpretq_s32_u32(
+            vshrq_n_u32(vmull_n_u16(vget_low_u16(y16), kYG), 16)),
+        yb);
+    int32x4_t y_hi = vaddq_s32(
+        vreinterpretq_s32_u32(
+            vshrq_n_u32(vmull_n_u16(vget_high_u16(y16), kYG), 16)),
+        yb);
+
+    uint32_t u4, v4;
+    memcpy(&u4, u + x / 2, 4);
+    memcpy(&v4, v + x / 2, 4);
+    uint8x8_t u8 = vreinterpret_u8_u32(vdup_n_u32(u4));
+    uint8x8_t v8 = vreinterpret_u8_u32(vdup_n_u32(v4));
+    int16x8_t u16 =
+        vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vzip1_u8(u8, u8))), uv_bias);
+    int16x8_t v16 =
+        vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vzip1_u8(v8, v8))), uv_bias);
+
+    uint8x8_t b8 = NarrowNEON(vmlal_n_s16(y_lo, vget_low_s16(u16), kUB),
+                              vmlal_n_s16(y_hi, vget_high_s16(u16), kUB));
+    uint8x8_t g8 = NarrowNEON(
+        vmlsl_n_s16(vmlsl_n_s16(y_lo, vget_low_s16(u16), kUG),
+                    vget_low_s16(v16), kVG),
+        vmlsl_n_s16(vmlsl_n_s16(y_hi, vget_high_s16(u16), kUG),
+                    vget_high_s16(v16), kVG));
+    uint8x8_t r8 = NarrowNEON(vmlal_n_s16(y_lo, vget_low_s16(v16), kVR),
+                              vmlal_n_s16(y_hi, vget_high_s16(v16), kVR));
+
+    uint8x8x4_t pixels;
+    pixels.val[0] = bgra ? b8 : r8;
+    pixels.val[1] = g8;
+    pixels.val[2] = bgra ? r8 : b8;
+    pixels.val[3] = vdup_n_u8(255);
+    vst4_u8(dst + x * 4, pixels);
+  }
+  ConvertRowScalar(y + x, u + x / 2, v + x / 2, dst + x * 4, width - x, bgra);
+}
+
+#endif  // FLUTTER_WEBRTC_YUV_NEON
+
+// Averages each destination pixel's footprint in the source plane, for
+// destination rows [first_row, first_row + row_count); |dst| points at
+// |first_row|. Column footprints are precomputed once per call; rows are
+// summed into |sums|.
+void ScalePlaneBox(const uint8_t* src,
+                   int src_stride,
+                   int src_width,
+                   int src_height,
+                   uint8_t* dst,
+                   int dst_stride,
+                   int dst_width,
+                   int dst_height,
+                   int first_row,
+                   int row_count,
+                   I420ScaleScratch* scratch) {
+  std::vector<int>& columns = scratch->columns;
+  columns.resize(dst_width + 1);
+  for (int x = 0; x <= dst_width; x++) {
+    columns[x] = static_cast<int>(int64_t(x) * src_width / dst_width);
+  }
+  std::vector<uint32_t>& sums = scratch->sums;
+  sums.resize(dst_width);
+
+  for (int y = first_row; y < first_row + row_count; y++) {
+    int y_begin = static_cast<int>(int64_t(y) * src_height / dst_height);
+    int y_end = static_cast<int>(int64_t(y + 1) * src_height / dst_height);
+    if (y_end <= y_begin)
+      y_end = y_begin + 1;
+    std::fill(sums.begin(), sums.end(), 0);
+    for (int sy = y_begin; sy < y_end; sy++) {
+      const uint8_t* row = src + sy * src_stride;
+      for (int x = 0; x < dst_width; x++) {
+        int x_end = std::max(columns[x + 1], columns[x] + 1);
+        uint32_t sum = 0;
+        for (int sx = columns[x]; sx < x_end; sx++)
+          sum += row[sx];
+        sums[x] += sum;
+      }
+    }
+    uint8_t* out = dst + (y - first_row) * dst_stride;
+    for (int x = 0; x < dst_width; x++) {
+      uint32_t area = uint32_t(y_end - y_begin) *
+                      uint32_t(std::max(columns[x + 1] - columns[x], 1));
+      out[x] = static_cast<uint8_t>((sums[x] + area / 2) / area);
+    }
+  }
+}
+
+// Bilinear resampling of an image of |kChannels| bytes per pixel. Sample
+// positions are pixel centers, so edges are not shifted; |columns| holds the
+// per-column source positions between calls.
+template <int kChannels>
+void ResizeBilinear(const uint8_t* src,
+                    int src_stride,
+                    int src_width,
+                    int src_height,
+                    uint8_t* dst,
+                    int dst_stride,
+                    int dst_width,
+                    int dst_height,
+                    std::vector<int>* columns) {
+  if (src_width <= 0 || src_height <= 0 || dst_width <= 0 || dst_height <= 0)
+    return;
+  // Position of destination pixel |i|'s center in the source, in 1/256ths
+  // of a source pixel, clamped to the outermost source centers.
+  auto source_position = [](int i, int src_size, int dst_size) {
+    int64_t position =
+        (int64_t(2 * i + 1) * src_size * 256) / (2 * dst_size) - 128;
+    return static_cast<int>(
+        std::min<int64_t>(std::max<int64_t>(position, 0),
+                          int64_t(src_size - 1) * 256));
+  };
+  columns->resize(dst_width);
+  for (int x = 0; x < dst_width; x++) {
+    (*columns)[x] = source_position(x, src_width, dst_width);
+  }
+  for (int y = 0; y < dst_height; y++) {
+    int row_position = source_position(y, src_height, dst_height);
+    int y0 = row_position >> 8;
+    int y1 = std::min(y0 + 1, src_height - 1);
+    int wy = row_position & 255;
+    const uint8_t* top = src + y0 * src_stride;
+    const uint8_t* bottom = src + y1 * src_stride;
+    uint8_t* out = dst + y * dst_stride;
+    for (int x = 0; x < dst_width; x++) {
+      int x0 = (*columns)[x] >> 8;
+      int x1 = std::min(x0 + 1, src_width - 1);
+      int wx = (*columns)[x] & 255;
+      for (int c = 0; c < kChannels; c++) {
+        int upper = top[x0 * kChannels + c] * (256 - wx) +
+                    top[x1 * kChannels + c] * wx;
+        int lower = bottom[x0 * kChannels + c] * (256 - wx) +
+                    bottom[x1 * kChannels + c] * wx;
+        out[x * kChannels + c] = static_cast<uint8_t>(
+            (upper * (256 - wy) + lower * wy + 32768) >> 16);
+      }
+    }
+  }
+}
+
+struct ConvertBackend {
+  ConvertRowFunc convert_row;
+  const char* name;
+};
+
+// The paths this CPU can run, best first. Scalar is always last.
+std::vector<ConvertBackend> SupportedBackends() {
+  std::vector<ConvertBackend> backends;
+#if defined(FLUTTER_WEBRTC_YUV_X86)
+  if (CpuHasAvx2())
+    backends.push_back({&ConvertRowAVX2, "avx2"});
+  if (CpuHasSse2())
+    backends.push_back({&ConvertRowSSE2, "sse2"});
+#elif defined(FLUTTER_WEBRTC_YUV_NEON)
+  backends.push_back({&ConvertRowNEON, "neon"});
+#endif
+  backends.push_back({&ConvertRowScalar, "scalar"});
+  return backends;
+}
+
+const std::vector<ConvertBackend>& Backends() {
+  static const std::vector<ConvertBackend> backends = SupportedBackends();
+  return backends;
+}
+
+const ConvertBackend& Backend() {
+  return Backends().front();
+}
+
+void ConvertRows(ConvertRowFunc convert_row,
+                 const I420Planes& src,
+                 RgbaLayout layout,
+                 uint8_t* dst,
+                 int dst_stride) {
+  if (dst_stride <= 0)
+    dst_stride = src.width * 4;
+  const bool bgra = layout == RgbaLayout::kBGRA;
+  for (int row = 0; row < src.height; row++) {
+    convert_row(src.y + row * src.stride_y, src.u + (row / 2) * src.stride_u,
+                src.v + (row / 2) * src.stride_v, dst + row * dst_stride,
+                src.width, bgra);
+  }
+}
+
+// Where source rows [first_row, first_row + rows) of a |height|-row image
+// land in |dst| after a clockwise |rotation|.
+uint8_t* RotatedBandOrigin(uint8_t* dst,
+                           int dst_stride,
+                           int height,
+                           int first_row,
+                           int rows,
+                           RTCVideoFrame::VideoRotation rotation) {
+  switch (rotation) {
+    case RTCVideoFrame::kVideoRotation_90:
+      return dst + size_t(height - first_row - rows) * 4;
+    case RTCVideoFrame::kVideoRotation_180:
+      return dst + size_t(height - first_row - rows) * dst_stride;
+    case RTCVideoFrame::kVideoRotation_270:
+      return dst + size_t(first_row) * 4;
+    default:
+      return dst + size_t(first_row) * dst_stride;
+  }
+}
+
+}  // namespace
+
+I420Planes I420PlanesFromFrame(const RTCVideoFrame& frame) {
+  I420Planes planes;
+  planes.y = frame.DataY();
+  planes.u = frame.DataU();
+  planes.v = frame.DataV();
+  planes.stride_y = frame.StrideY();
+  planes.stride_u = frame.StrideU();
+  planes.stride_v = frame.StrideV();
+  planes.width = frame.width();
+  planes.height = frame.height();
+  return planes;
+}
+
+void ConvertI420ToRgba(const I420Planes& src,
+                       RgbaLayout layout,
+                       uint8_t* dst,
+                       int dst_stride) {
+  ConvertRows(Backend().convert_row, src, layout, dst, dst_stride);
+}
+
+bool ConvertI420ToRgbaWithBackend(const std::string& backend,
+                                  const I420Planes& src,
+                                  RgbaLayout layout,
+                                  uint8_t* dst,
+                                  int dst_stride) {
+  for (const ConvertBackend& candidate : Backends()) {
+    if (backend == candidate.name) {
+      ConvertRows(candidate.convert_row, src, layout, dst, dst_stride);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ScaleI420ToRgba(const I420Planes& src,
+                     int dst_width,
+                     int dst_height,
+                     RgbaLayout layout,
+                     uint8_t* dst,
+                     int dst_stride,
+                     I420ScaleScratch* scratch) {
+  ScaleI420ToRgbaRows(src, dst_width, dst_height, 0, src.height, layout, dst,
+                      dst_stride, scratch);
+}
+
+void ScaleI420ToRgbaRows(const I420Planes& src,
+                         int dst_width,
+                         int dst_height,
+                         int first_row,
+                         int row_count,
+                         RgbaLayout layout,
+                         uint8_t* dst,
+                         int dst_stride,
+                         I420ScaleScratch* scratch) {
+  if (dst_width >= src.width && dst_height >= src.height) {
+    I420Planes band = src;
+    band.y += first_row * src.stride_y;
+    band.u += (first_row / 2) * src.stride_u;
+    band.v += (first_row / 2) * src.stride_v;
+    band.height = std::min(row_count, src.height - first_row);
+    ConvertI420ToRgba(band, layout, dst, dst_stride);
+    return;
+  }
+  dst_width = std::max(1, std::min(dst_width, src.width));
+  dst_height = std::max(1, std::min(dst_height, src.height));
+  row_count = std::min(row_count, dst_height - first_row);
+  if (row_count <= 0)
+    return;
+
+  const int chroma_width = (dst_width + 1) / 2;
+  const int chroma_height = (dst_height + 1) / 2;
+  const int chroma_first_row = first_row / 2;
+  const int chroma_rows =
+      std::min((first_row + row_count + 1) / 2, chroma_height) -
+      chroma_first_row;
+  const size_t luma_size = size_t(dst_width) * row_count;
+  const size_t chroma_size = size_t(chroma_width) * chroma_rows;
+  scratch->planes.resize(luma_size + 2 * chroma_size);
+
+  I420Planes scaled;
+  uint8_t* y = scratch->planes.data();
+  uint8_t* u = y + luma_size;
+  uint8_t* v = u + chroma_size;
+  scaled.y = y;
+  scaled.u = u;
+  scaled.v = v;
+  scaled.stride_y = dst_width;
+  scaled.stride_u = chroma_width;
+  scaled.stride_v = chroma_width;
+  scaled.width = dst_width;
+  scaled.height = row_count;
+
+  const int src_chroma_width = (src.width + 1) / 2;
+  const int src_chroma_height = (src.height + 1) / 2;
+  ScalePlaneBox(src.y, src.stride_y, src.width, src.height, y, dst_width,
+                dst_width, dst_height, first_row, row_count, scratch);
+  ScalePlaneBox(src.u, src.stride_u, src_chroma_width, src_chroma_height, u,
+                chroma_width, chroma_width, chroma_height, chroma_first_row,
+                chroma_rows, scratch);
+  ScalePlaneBox(src.v, src.stride_v, src_chroma_width, src_chroma_height, v,
+                chroma_width, chroma_width, chroma_height, chroma_first_row,
+                chroma_rows, scratch);
+  ConvertI420ToRgba(scaled, layout, dst, dst_stride);
+}
+
+void RotateRgba(const uint8_t* src,
+                int src_stride,
+                int width,
+                int height,
+                RTCVideoFrame::VideoRotation rotation,
+                uint8_t* dst,
+                int dst_stride) {
+  // Walk the source in small tiles so the scattered writes of a 90/270
+  // degree rotation stay within a few cache lines.
+  constexpr int kTile = 16;
+  for (int tile_y = 0; tile_y < height; tile_y += kTile) {
+    const int y_end = std::min(tile_y + kTile, height);
+    for (int tile_x = 0; tile_x < width; tile_x += kTile) {
+      const int x_end = std::min(tile_x + kTile, width);
+      for (int y = tile_y; y < y_end; y++) {
+        const uint8_t* in = src + y * src_stride;
+        for (int x = tile_x; x < x_end; x++) {
+          int dst_x, dst_y;
+          switch (rotation) {
+            case RTCVideoFrame::kVideoRotation_90:
+              dst_x = height - 1 - y;
+              dst_y = x;
+              break;
+            case RTCVideoFrame::kVideoRotation_180:
+              dst_x = width - 1 - x;
+              dst_y = height - 1 - y;
+              break;
+            case RTCVideoFrame::kVideoRotation_270:
+              dst_x = y;
+              dst_y = width - 1 - x;
+              break;
+            default:
+              dst_x = x;
+              dst_y = y;
+              break;
+          }
+          memcpy(dst + dst_y * dst_stride + dst_x * 4, in + x * 4, 4);
+        }
+      }
+    }
+  }
+}
+
+void ConvertI420ToRgbaBands(const I420Planes& src,
+                            int width,
+                            int height,
+                            RTCVideoFrame::VideoRotation rotation,
+                            size_t bands,
+                            WorkerPool* pool,
+                            RgbaLayout layout,
+                            uint8_t* dst,
+                            int dst_stride,
+                            I420BandScratch* scratch) {
+  bands = std::max<size_t>(bands, 1);
+  if (scratch->bands.size() < bands)
+    scratch->bands.resize(bands);
+  if (rotation != RTCVideoFrame::kVideoRotation_0)
+    scratch->rotated.resize(size_t(width) * height * 4);
+  // Bands start on even rows so each begins on a chroma row.
+  const int band_rows = ((height + int(bands) - 1) / int(bands) + 1) & ~1;
+  auto convert_band = [&](size_t band) {
+    const int first_row = static_cast<int>(band) * band_rows;
+    if (first_row >= height)
+      return;
+    const int rows = std::min(band_rows, height - first_row);
+    I420ScaleScratch* band_scratch = &scratch->bands[band];
+    if (rotation == RTCVideoFrame::kVideoRotation_0) {
+      ScaleI420ToRgbaRows(src, width, height, first_row, rows, layout,
+                          dst + size_t(first_row) * dst_stride, dst_stride,
+                          band_scratch);
+      return;
+    }
+    uint8_t* band_pixels =
+        scratch->rotated.data() + size_t(first_row) * width * 4;
+    ScaleI420ToRgbaRows(src, width, height, first_row, rows, layout,
+                        band_pixels, width * 4, band_scratch);
+    RotateRgba(band_pixels, width * 4, width, rows, rotation,
+               RotatedBandOrigin(dst, dst_stride, height, first_row, rows,
+                                 rotation),
+               dst_stride);
+  };
+  if (bands > 1) {
+    pool->ParallelFor(bands, convert_band);
+  } else {
+    convert_band(0);
+  }
+}
+
+void ResizeRgbaBilinear(const uint8_t* src,
+                        int src_stride,
+                        int src_width,
+                        int src_height,
+                        uint8_t* dst,
+                        int dst_stride,
+                        int dst_width,
+                        int dst_height) {
+  std::vector<int> columns;
+  ResizeBilinear<4>(src, src_stride, src_width, src_height, dst, dst_stride,
+                    dst_width, dst_height, &columns);
+}
+
+void ScaleI420(const I420Planes& src,
+               int dst_width,
+               int dst_height,
+               uint8_t* dst_y,
+               int dst_stride_y,
+               uint8_t* dst_u,
+               int dst_stride_u,
+               uint8_t* dst_v,
+               int dst_stride_v,
+               I420ScaleScratch* scratch) {
+  if (dst_width <= 0 || dst_height <= 0)
+    return;
+  const bool shrink = dst_width <= src.width && dst_height <= src.height;
+  auto scale_plane = [&](const uint8_t* plane, int stride, int width,
+                         int height, uint8_t* out, int out_stride,
+                         int out_width, int out_height) {
+    if (shrink) {
+      ScalePlaneBox(plane, stride, width, height, out, out_stride, out_width,
+                    out_height, 0, out_height, scratch);
+    } else {
+      ResizeBilinear<1>(plane, stride, width, height, out, out_stride,
+                        out_width, out_height, &scratch->columns);
+    }
+  };
+  scale_plane(src.y, src.stride_y, src.width, src.height, dst_y, dst_stride_y,
+              dst_width, dst_height);
+  const int src_chroma_width = (src.width + 1) / 2;
+  const int src_chroma_height = (src.height + 1) / 2;
+  const int chroma_width = (dst_width + 1) / 2;
+  const int chroma_height = (dst_height + 1) / 2;
+  scale_plane(src.u, src.stride_u, src_chroma_width, src_chroma_height, dst_u,
+              dst_stride_u, chroma_width, chroma_height);
+  scale_plane(src.v, src.stride_v, src_chroma_width, src_chroma_height, dst_v,
+              dst_stride_v, chroma_width, chroma_height);
+}
+
+const char* YuvConverterBackend() {
+  return Backend().name;
+}
+
+std::vector<std::string> YuvConverterBackends() {
+  std::vector<std::string> names;
+  for (const ConvertBackend& backend : Backends()) {
+    names.push_back(backend.name);
+  }
+  return names;
+}
+
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,189 @@
+// Reading method call arguments must not copy them: the handlers for hot
+// calls such as setRemoteDescription and rtpSenderSetParameters read their
+// arguments through ArgView and the find*Ref helpers, and nothing on that
+// path may allocate. Counts global operator new calls to check.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "flutter_common.h"
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<size_t> g_allocations{0};
+
+void* CountedAlloc(size_t size) {
+  if (g_counting.load(std::memory_order_relaxed))
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  return CountedAlloc(size);
+}
+void* operator new[](size_t size) {
+  return CountedAlloc(size);
+}
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+// Allocations made by |body|.
+template <typename Body>
+size_t CountAllocations(Body body) {
+  g_allocations = 0;
+  g_counting = true;
+  body();
+  g_counting = false;
+  return g_allocations;
+}
+
+// A remote description long enough that any copy of it would allocate.
+EncodableValue SetRemoteDescriptionArguments() {
+  EncodableMap description;
+  description[EncodableValue("type")] = EncodableValue("offer");
+  description[EncodableValue("sdp")] = EncodableValue(
+      std::string(4096, 'a') + "\r\nm=video 9 UDP/TLS/RTP/SAVPF 96\r\n");
+  EncodableMap params;
+  params[EncodableValue("peerConnectionId")] =
+      EncodableValue("0123456789abcdef0123456789abcdef");
+  params[EncodableValue("description")] = EncodableValue(description);
+  return EncodableValue(params);
+}
+
+EncodableValue RtpSenderSetParametersArguments() {
+  EncodableList encodings;
+  for (const char* rid : {"low-resolution-layer", "mid-resolution-layer",
+                          "high-resolution-layer"}) {
+    EncodableMap encoding;
+    encoding[EncodableValue("active")] = EncodableValue(true);
+    encoding[EncodableValue("rid")] = EncodableValue(rid);
+    encoding[EncodableValue("maxBitrate")] = EncodableValue(2500000);
+    encoding[EncodableValue("maxFramerate")] = EncodableValue(30);
+    encoding[EncodableValue("scaleResolutionDownBy")] = EncodableValue(2.0);
+    encoding[EncodableValue("scalabilityMode")] = EncodableValue("L1T3");
+    encodings.push_back(EncodableValue(encoding));
+  }
+  EncodableMap parameters;
+  parameters[EncodableValue("encodings")] = EncodableValue(encodings);
+  parameters[EncodableValue("degradationPreference")] =
+      EncodableValue("maintain-resolution");
+  EncodableMap params;
+  params[EncodableValue("peerConnectionId")] =
+      EncodableValue("0123456789abcdef0123456789abcdef");
+  params[EncodableValue("rtpSenderId")] =
+      EncodableValue("fedcba9876543210fedcba9876543210");
+  params[EncodableValue("parameters")] = EncodableValue(parameters);
+  return EncodableValue(params);
+}
+
+// The reads FlutterWebRTC::HandleSetRemoteDescription makes.
+TEST(ArgViewTest, SetRemoteDescriptionArgumentsAreNotCopied) {
+  EncodableValue arguments = SetRemoteDescriptionArguments();
+  size_t sdp_size = 0;
+  size_t allocations = CountAllocations([&]() {
+    const ArgView params(&arguments);
+    const std::string& peerConnectionId = params.String("peerConnectionId");
+    const ArgView constraints = params.Map("description");
+    const std::string& type = constraints.String("type");
+    const std::string& sdp = constraints.String("sdp");
+    sdp_size = peerConnectionId.size() + type.size() + sdp.size();
+  });
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_EQ(sdp_size, 32u + 5u + 4096u + 34u);
+}
+
+// The reads FlutterWebRTC::HandleRtpSenderSetParameters and
+// FlutterPeerConnection::updateRtpParameters make.
+TEST(ArgViewTest, RtpSenderSetParametersArgumentsAreNotCopied) {
+  EncodableValue arguments = RtpSenderSetParametersArguments();
+  size_t found = 0;
+  size_t allocations = CountAllocations([&]() {
+    const ArgView params(&arguments);
+    found += !params.String("peerConnectionId").empty();
+    found += !params.String("rtpSenderId").empty();
+    const ArgView parameters = params.Map("parameters");
+    const EncodableList* encodings =
+        findListRef(parameters.map(), "encodings");
+    for (const EncodableValue& encoding : *encodings) {
+      const EncodableMap& map = GetValue<EncodableMap>(encoding);
+      for (const char* key :
+           {"active", "rid", "ssrc", "maxBitrate", "minBitrate",
+            "maxFramerate", "numTemporalLayers", "scaleResolutionDownBy",
+            "scalabilityMode"}) {
+        found += findValueRef(map, key) != nullptr;
+      }
+    }
+    found += findValueRef(parameters.map(), "degradationPreference") !=
+             nullptr;
+  });
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_EQ(found, 2u + 3u * 6u + 1u);
+}
+
+TEST(ArgViewTest, AddCandidateArgumentsAreNotCopied) {
+  EncodableMap candidate;
+  candidate[EncodableValue("candidate")] = EncodableValue(
+      "candidate:842163049 1 udp 1677729535 203.0.113.7 46154 typ srflx "
+      "raddr 10.0.0.2 rport 46154 generation 0 ufrag EsAw network-cost 999");
+  candidate[EncodableValue("sdpMid")] = EncodableValue("0");
+  candidate[EncodableValue("sdpMLineIndex")] = EncodableValue(0);
+  EncodableMap map;
+  map[EncodableValue("peerConnectionId")] =
+      EncodableValue("0123456789abcdef0123456789abcdef");
+  map[EncodableValue("candidate")] = EncodableValue(candidate);
+  EncodableValue arguments(map);
+
+  int index = -1;
+  size_t allocations = CountAllocations([&]() {
+    const ArgView params(&arguments);
+    const ArgView constraints = params.Map("candidate");
+    const std::string& line = constraints.String("candidate");
+    index = line.empty() ? -1 : constraints.Int("sdpMLineIndex");
+  });
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_EQ(index, 0);
+}
+
+// The allocation-free lookup finds what std::map::find would, whatever
+// other key types share the map.
+TEST(ArgViewTest, LookupMatchesMapFind) {
+  EncodableMap map;
+  map[EncodableValue(7)] = EncodableValue("int key");
+  map[EncodableValue(true)] = EncodableValue("bool key");
+  for (const char* key : {"a", "ab", "b", "peerConnectionId", "z"})
+    map[EncodableValue(key)] = EncodableValue(std::string(key) + "!");
+  map[EncodableValue(EncodableList{})] = EncodableValue("list key");
+
+  for (const char* key : {"a", "ab", "b", "peerConnectionId", "z"}) {
+    const std::string* value = findStringRef(map, key);
+    ASSERT_NE(value, nullptr) << key;
+    EXPECT_EQ(*value, std::string(key) + "!");
+  }
+  for (const char* key : {"", "aa", "c", "peerConnection", "zz"})
+    EXPECT_EQ(findValueRef(map, key), nullptr) << key;
+}
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,14 @@
+#include <benchmark/benchmark.h>
+
+#include "flutter_common.h"
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+  // As in test_main.cc: the benchmark thread plays the platform thread.
+  TaskRunner::InitializePlatform();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,60 @@
+// A burst of 10k events through EventChannelProxy, as a busy data channel
+// produces, with and without batching: how fast they reach the Dart side and
+// in how many platform messages.
+
+#include <benchmark/benchmark.h>
+
+#include "fake_platform.h"
+#include "flutter_common.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+constexpr char kChannel[] = "FlutterWebRTC/benchmark/events";
+constexpr int kBurst = 10000;
+
+void BM_EventBurst(benchmark::State& state, bool batched) {
+  size_t messages = 0;
+  for (auto _ : state) {
+    test::FakeMessenger messenger;
+    EventQueueOptions options =
+        batched ? EventQueueOptions::Batched() : EventQueueOptions();
+    // Room for the whole burst: this measures delivery, not dropping.
+    options.capacity = kBurst;
+    std::unique_ptr<EventChannelProxy> proxy =
+        EventChannelProxy::Create(&messenger, kChannel, options);
+    size_t received = 0;
+    messenger.SetEventHandler(kChannel, [&received](const EncodableValue& e) {
+      const EncodableList* batch = std::get_if<EncodableList>(&e);
+      received += batch ? batch->size() : 1;
+    });
+    messenger.Listen(kChannel);
+
+    for (int i = 0; i < kBurst; i++) {
+      EncodableMap event;
+      event[EncodableValue("event")] = "dataChannelReceiveMessage";
+      event[EncodableValue("data")] = EncodableValue(i);
+      proxy->Success(EncodableValue(event));
+    }
+    if (!test::RunPlatformTasksUntil(
+            [&received]() { return received == size_t(kBurst); })) {
+      state.SkipWithError("burst did not arrive");
+      break;
+    }
+    messages = messenger.message_count(kChannel);
+  }
+  state.SetItemsProcessed(state.iterations() * kBurst);
+  state.counters["events_per_s"] = benchmark::Counter(
+      double(state.iterations()) * kBurst, benchmark::Counter::kIsRate);
+  state.counters["engine_messages"] = double(messages);
+}
+
+BENCHMARK_CAPTURE(BM_EventBurst, unbatched, false)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_EventBurst, batched, true)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
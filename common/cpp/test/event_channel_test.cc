@@ -0,0 +1,147 @@
+// EventChannelProxy under concurrent producers: every event must reach the
+// Dart side exactly once, and each producer's events in the order it sent
+// them. Worth running with -DSANITIZER=thread.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "fake_platform.h"
+#include "flutter_common.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+constexpr char kChannel[] = "FlutterWebRTC/test/events";
+constexpr int kProducers = 8;
+constexpr int kEventsPerProducer = 5000;
+
+// Events received per producer, with batches unpacked.
+class Receiver {
+ public:
+  explicit Receiver(test::FakeMessenger* messenger)
+      : received_(kProducers) {
+    messenger->SetEventHandler(kChannel, [this](const EncodableValue& event) {
+      if (const EncodableList* batch = std::get_if<EncodableList>(&event)) {
+        for (const EncodableValue& item : *batch)
+          Receive(item);
+      } else {
+        Receive(event);
+      }
+    });
+  }
+
+  size_t total() const { return total_; }
+
+  // Checks that producer |producer| got through completely and in order.
+  ::testing::AssertionResult Complete(int producer) const {
+    const std::vector<int>& sequence = received_[producer];
+    for (size_t i = 0; i < sequence.size(); i++) {
+      if (sequence[i] != int(i)) {
+        return ::testing::AssertionFailure()
+               << "producer " << producer << ": event " << i << " is "
+               << sequence[i];
+      }
+    }
+    if (sequence.size() != kEventsPerProducer) {
+      return ::testing::AssertionFailure()
+             << "producer " << producer << ": " << sequence.size() << " of "
+             << kEventsPerProducer << " events";
+    }
+    return ::testing::AssertionSuccess();
+  }
+
+ private:
+  void Receive(const EncodableValue& event) {
+    const EncodableMap& map = GetValue<EncodableMap>(event);
+    int producer = GetValue<int>(map.at(EncodableValue("producer")));
+    int sequence = GetValue<int>(map.at(EncodableValue("sequence")));
+    received_[producer].push_back(sequence);
+    total_++;
+  }
+
+  std::vector<std::vector<int>> received_;
+  size_t total_ = 0;
+};
+
+// Runs kProducers threads sending through |proxy| while the test thread
+// drains as the platform thread.
+void SendFromProducers(EventChannelProxy* proxy, const Receiver& receiver) {
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducers; producer++) {
+    producers.emplace_back([proxy, producer]() {
+      for (int sequence = 0; sequence < kEventsPerProducer; sequence++) {
+        EncodableMap event;
+        event[EncodableValue("producer")] = EncodableValue(producer);
+        event[EncodableValue("sequence")] = EncodableValue(sequence);
+        proxy->Success(EncodableValue(event));
+      }
+    });
+  }
+  EXPECT_TRUE(test::RunPlatformTasksUntil([&receiver]() {
+    return receiver.total() == size_t(kProducers) * kEventsPerProducer;
+  }));
+  for (std::thread& producer : producers)
+    producer.join();
+  // Nothing more trickles in after the last event.
+  test::RunPlatformTasks();
+  EXPECT_EQ(receiver.total(), size_t(kProducers) * kEventsPerProducer);
+}
+
+TEST(EventChannelTest, ConcurrentProducersArriveCompleteAndInOrder) {
+  test::FakeMessenger messenger;
+  std::unique_ptr<EventChannelProxy> proxy =
+      EventChannelProxy::Create(&messenger, kChannel);
+  Receiver receiver(&messenger);
+  messenger.Listen(kChannel);
+
+  SendFromProducers(proxy.get(), receiver);
+  for (int producer = 0; producer < kProducers; producer++)
+    EXPECT_TRUE(receiver.Complete(producer));
+  EXPECT_EQ(messenger.message_count(kChannel),
+            size_t(kProducers) * kEventsPerProducer);
+  EXPECT_EQ(proxy->dropped_events(), 0u);
+}
+
+TEST(EventChannelTest, ConcurrentProducersArriveCompleteAndInOrderBatched) {
+  test::FakeMessenger messenger;
+  std::unique_ptr<EventChannelProxy> proxy = EventChannelProxy::Create(
+      &messenger, kChannel, EventQueueOptions::Batched());
+  Receiver receiver(&messenger);
+  messenger.Listen(kChannel);
+
+  SendFromProducers(proxy.get(), receiver);
+  for (int producer = 0; producer < kProducers; producer++)
+    EXPECT_TRUE(receiver.Complete(producer));
+  EXPECT_LT(messenger.message_count(kChannel),
+            size_t(kProducers) * kEventsPerProducer);
+}
+
+// Before anyone listens, events are held in the bounded queue; the newest
+// |capacity| of them are delivered, still in order, on listen.
+TEST(EventChannelTest, EventsSentBeforeListenKeepTheNewest) {
+  test::FakeMessenger messenger;
+  EventQueueOptions options;
+  options.capacity = 16;
+  std::unique_ptr<EventChannelProxy> proxy =
+      EventChannelProxy::Create(&messenger, kChannel, options);
+  std::vector<int> received;
+  messenger.SetEventHandler(kChannel, [&received](const EncodableValue& event) {
+    received.push_back(GetValue<int>(event));
+  });
+
+  for (int i = 0; i < 100; i++)
+    proxy->Success(EncodableValue(i));
+  test::RunPlatformTasks();
+  EXPECT_TRUE(received.empty());
+  messenger.Listen(kChannel);
+
+  ASSERT_EQ(received.size(), 16u);
+  for (int i = 0; i < 16; i++)
+    EXPECT_EQ(received[i], 84 + i);
+  EXPECT_EQ(proxy->dropped_events(), 84u);
+}
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
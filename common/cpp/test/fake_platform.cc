@@ -0,0 +1,199 @@
+#include "fake_platform.h"
+
+#include <flutter/engine_method_result.h>
+#include <flutter/method_result_functions.h>
+#include <glib.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <utility>
+
+namespace flutter_webrtc_plugin {
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Source {
+  GSourceFunc function;
+  gpointer data;
+  GDestroyNotify notify;
+  std::chrono::milliseconds interval;
+};
+
+// Sources keyed by when they are due, then by when they were added, so idle
+// sources run in the order they were posted.
+struct MainLoop {
+  std::mutex mutex;
+  std::condition_variable added;
+  std::multimap<std::pair<Clock::time_point, guint>, Source> sources;
+  guint next_id = 1;
+};
+
+MainLoop& Loop() {
+  static MainLoop* loop = new MainLoop();
+  return *loop;
+}
+
+guint AddSource(std::chrono::milliseconds interval, Source source) {
+  MainLoop& loop = Loop();
+  std::lock_guard<std::mutex> lock(loop.mutex);
+  guint id = loop.next_id++;
+  loop.sources.emplace(std::make_pair(Clock::now() + interval, id), source);
+  loop.added.notify_all();
+  return id;
+}
+
+}  // namespace
+
+size_t RunPlatformTasks() {
+  MainLoop& loop = Loop();
+  size_t ran = 0;
+  for (;;) {
+    Source source;
+    {
+      std::lock_guard<std::mutex> lock(loop.mutex);
+      auto first = loop.sources.begin();
+      if (first == loop.sources.end() || first->first.first > Clock::now())
+        return ran;
+      source = first->second;
+      loop.sources.erase(first);
+    }
+    if (source.function(source.data) == G_SOURCE_CONTINUE) {
+      AddSource(source.interval, source);
+    } else if (source.notify) {
+      source.notify(source.data);
+    }
+    ran++;
+  }
+}
+
+bool RunPlatformTasksUntil(const std::function<bool()>& done,
+                           std::chrono::milliseconds timeout) {
+  MainLoop& loop = Loop();
+  Clock::time_point deadline = Clock::now() + timeout;
+  for (;;) {
+    RunPlatformTasks();
+    if (done())
+      return true;
+    if (Clock::now() >= deadline)
+      return false;
+    // Sleep until the next source is due or a new one is added, polling
+    // |done| now and then for work that happens off the platform thread.
+    std::unique_lock<std::mutex> lock(loop.mutex);
+    Clock::time_point wake =
+        std::min(deadline, Clock::now() + std::chrono::milliseconds(10));
+    if (!loop.sources.empty())
+      wake = std::min(wake, loop.sources.begin()->first.first);
+    loop.added.wait_until(lock, wake);
+  }
+}
+
+void FakeMessenger::Send(const std::string& channel,
+                         const uint8_t* message,
+                         size_t message_size,
+                         flutter::BinaryReply reply) const {
+  EventHandler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    message_counts_[channel]++;
+    auto it = event_handlers_.find(channel);
+    if (it != event_handlers_.end())
+      handler = it->second;
+  }
+  // An empty message ends the stream.
+  if (!handler || message_size == 0)
+    return;
+  flutter::MethodResultFunctions<EncodableValue> result(
+      [&handler](const EncodableValue* event) {
+        handler(event ? *event : EncodableValue());
+      },
+      nullptr, nullptr);
+  flutter::StandardMethodCodec::GetInstance().DecodeAndProcessResponseEnvelope(
+      message, message_size, &result);
+}
+
+void FakeMessenger::SetMessageHandler(const std::string& channel,
+                                      flutter::BinaryMessageHandler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (handler) {
+    handlers_[channel] = std::move(handler);
+  } else {
+    handlers_.erase(channel);
+  }
+}
+
+void FakeMessenger::InvokeMethod(const std::string& channel,
+                                 const std::string& method,
+                                 std::unique_ptr<EncodableValue> arguments) {
+  flutter::BinaryMessageHandler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = handlers_.find(channel);
+    if (it == handlers_.end())
+      return;
+    handler = it->second;
+  }
+  MethodCall call(method, std::move(arguments));
+  std::unique_ptr<std::vector<uint8_t>> message =
+      flutter::StandardMethodCodec::GetInstance().EncodeMethodCall(call);
+  handler(message->data(), message->size(),
+          [](const uint8_t* reply, size_t reply_size) {});
+}
+
+void FakeMessenger::SetEventHandler(const std::string& channel,
+                                    EventHandler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  event_handlers_[channel] = std::move(handler);
+}
+
+size_t FakeMessenger::message_count(const std::string& channel) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = message_counts_.find(channel);
+  return it == message_counts_.end() ? 0 : it->second;
+}
+
+}  // namespace test
+}  // namespace flutter_webrtc_plugin
+
+guint g_idle_add_full(gint priority,
+                      GSourceFunc function,
+                      gpointer data,
+                      GDestroyNotify notify) {
+  return flutter_webrtc_plugin::test::AddSource(
+      std::chrono::milliseconds(0), {function, data, notify, {}});
+}
+
+guint g_timeout_add_full(gint priority,
+                         guint interval,
+                         GSourceFunc function,
+                         gpointer data,
+                         GDestroyNotify notify) {
+  std::chrono::milliseconds delay(interval);
+  return flutter_webrtc_plugin::test::AddSource(
+      delay, {function, data, notify, delay});
+}
+
+// What MethodChannel replies through. The real one is in
+// core_implementations.cc, which needs GTK.
+namespace flutter {
+namespace internal {
+
+ReplyManager::ReplyManager(BinaryReply reply_handler)
+    : reply_handler_(std::move(reply_handler)) {}
+
+ReplyManager::~ReplyManager() {}
+
+void ReplyManager::SendResponseData(const std::vector<uint8_t>* data) {
+  if (!reply_handler_)
+    return;
+  const uint8_t* message = data && !data->empty() ? data->data() : nullptr;
+  size_t message_size = data ? data->size() : 0;
+  reply_handler_(message, message_size);
+  reply_handler_ = nullptr;
+}
+
+}  // namespace internal
+}  // namespace flutter
@@ -0,0 +1,64 @@
+#ifndef FLUTTER_WEBRTC_TEST_FAKE_PLATFORM_H_
+#define FLUTTER_WEBRTC_TEST_FAKE_PLATFORM_H_
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "flutter_common.h"
+
+namespace flutter_webrtc_plugin {
+namespace test {
+
+// Runs the platform tasks that are due, in order, on the calling thread,
+// which must be the one the test main bound the platform runner to.
+// Returns how many ran.
+size_t RunPlatformTasks();
+
+// Runs platform tasks as they fall due until |done| returns true or
+// |timeout| passes. Returns the last result of |done|.
+bool RunPlatformTasksUntil(
+    const std::function<bool()>& done,
+    std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+// Stands in for the engine on the other end of the plugin's channels.
+class FakeMessenger : public BinaryMessenger {
+ public:
+  // Called with every success event sent on a channel, decoded.
+  using EventHandler = std::function<void(const EncodableValue& event)>;
+
+  void Send(const std::string& channel,
+            const uint8_t* message,
+            size_t message_size,
+            flutter::BinaryReply reply = nullptr) const override;
+
+  void SetMessageHandler(const std::string& channel,
+                         flutter::BinaryMessageHandler handler) override;
+
+  // Delivers a method call to the handler the plugin registered for
+  // |channel|, as the Dart side would.
+  void InvokeMethod(const std::string& channel,
+                    const std::string& method,
+                    std::unique_ptr<EncodableValue> arguments = nullptr);
+
+  // Subscribes to an event channel: "listen", as a Dart listener does.
+  void Listen(const std::string& channel) { InvokeMethod(channel, "listen"); }
+
+  void SetEventHandler(const std::string& channel, EventHandler handler);
+
+  // Platform messages sent on |channel| so far.
+  size_t message_count(const std::string& channel) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, flutter::BinaryMessageHandler> handlers_;
+  std::map<std::string, EventHandler> event_handlers_;
+  mutable std::map<std::string, size_t> message_counts_;
+};
+
+}  // namespace test
+}  // namespace flutter_webrtc_plugin
+
+#endif  // FLUTTER_WEBRTC_TEST_FAKE_PLATFORM_H_
@@ -0,0 +1,9 @@
+#ifndef FLUTTER_WEBRTC_TEST_FAKES_FLUTTER_LINUX_H_
+#define FLUTTER_WEBRTC_TEST_FAKES_FLUTTER_LINUX_H_
+
+// Just enough of the GTK embedder's API for the client wrapper headers to
+// compile. Nothing here is ever called.
+
+typedef struct _FlPluginRegistrar FlPluginRegistrar;
+
+#endif  // FLUTTER_WEBRTC_TEST_FAKES_FLUTTER_LINUX_H_
@@ -0,0 +1,29 @@
+#ifndef FLUTTER_WEBRTC_TEST_FAKES_GLIB_H_
+#define FLUTTER_WEBRTC_TEST_FAKES_GLIB_H_
+
+// The GLib main loop functions the plugin's platform task runner calls.
+// fake_platform.cc queues the sources and RunPlatformTasks() runs them.
+
+typedef int gboolean;
+typedef void* gpointer;
+typedef unsigned int guint;
+typedef int gint;
+typedef gboolean (*GSourceFunc)(gpointer user_data);
+typedef void (*GDestroyNotify)(gpointer data);
+
+#define G_PRIORITY_DEFAULT 0
+#define G_SOURCE_REMOVE 0
+#define G_SOURCE_CONTINUE 1
+
+guint g_idle_add_full(gint priority,
+                      GSourceFunc function,
+                      gpointer data,
+                      GDestroyNotify notify);
+
+guint g_timeout_add_full(gint priority,
+                         guint interval,
+                         GSourceFunc function,
+                         gpointer data,
+                         GDestroyNotify notify);
+
+#endif  // FLUTTER_WEBRTC_TEST_FAKES_GLIB_H_
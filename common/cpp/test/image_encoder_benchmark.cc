@@ -0,0 +1,94 @@
+// Encode time and file size of the plugin's PNG and JPEG encoders against
+// svpng, which the plugin used to write frame captures with.
+
+#include "flutter_image_encoder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "test_images.h"
+
+#define SVPNG_LINKAGE static
+#define SVPNG_OUTPUT std::vector<uint8_t>* out
+#define SVPNG_PUT(u) out->push_back(static_cast<uint8_t>(u))
+#include "svpng.hpp"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+using test::MakeRgbaImage;
+using test::RgbaPattern;
+
+enum class Encoder { kSvpng, kPng, kJpeg };
+
+void BM_Encode(benchmark::State& state,
+               Encoder encoder,
+               RgbaPattern pattern,
+               int width,
+               int height) {
+  std::mt19937 rng(3);
+  std::vector<uint8_t> rgba =
+      MakeRgbaImage(pattern, width, height, width * 4, &rng);
+  ImageEncodeOptions options;
+  options.format =
+      encoder == Encoder::kJpeg ? ImageFormat::kJpeg : ImageFormat::kPng;
+  std::vector<uint8_t> out;
+  for (auto _ : state) {
+    if (encoder == Encoder::kSvpng) {
+      // As the plugin called it: RGBA, alpha included.
+      out.clear();
+      svpng(&out, width, height, rgba.data(), 1);
+    } else {
+      EncodeImage(rgba.data(), width, height, width * 4, options, &out);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["file_bytes"] = double(out.size());
+  state.counters["bytes_per_pixel"] = double(out.size()) / (width * height);
+}
+
+const bool kRegistered = [] {
+  struct {
+    const char* name;
+    Encoder encoder;
+  } encoders[] = {
+      {"svpng", Encoder::kSvpng},
+      {"png", Encoder::kPng},
+      {"jpeg90", Encoder::kJpeg},
+  };
+  struct {
+    const char* name;
+    RgbaPattern pattern;
+  } patterns[] = {
+      {"gradient", RgbaPattern::kGradient},
+      {"camera", RgbaPattern::kCamera},
+      {"noise", RgbaPattern::kNoise},
+  };
+  struct {
+    const char* name;
+    int width;
+    int height;
+  } sizes[] = {
+      {"720p", 1280, 720},
+      {"1080p", 1920, 1080},
+  };
+  for (const auto& size : sizes) {
+    for (const auto& pattern : patterns) {
+      for (const auto& encoder : encoders) {
+        std::string name = std::string("Encode/") + encoder.name + "/" +
+                           pattern.name + "/" + size.name;
+        benchmark::RegisterBenchmark(name.c_str(), BM_Encode, encoder.encoder,
+                                     pattern.pattern, size.width, size.height)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+      }
+    }
+  }
+  return true;
+}();
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,419 @@
+// Round-trips images through the plugin's PNG and JPEG encoders and decodes
+// them with zlib and libjpeg.
+
+#include "flutter_image_encoder.h"
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+// Needs stdio.h first.
+#include <jpeglib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_images.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+using test::MakeRgbaImage;
+using test::RgbaPattern;
+
+struct ImageSize {
+  int width;
+  int height;
+};
+
+// Odd sizes, single rows and columns, sizes around the deflate band height,
+// and the sizes cameras actually produce.
+constexpr ImageSize kSizes[] = {
+    {1, 1},     {3, 3},     {7, 5},     {16, 16},  {1, 64},
+    {64, 1},    {1, 1000},  {1000, 1},  {320, 240}, {641, 361},
+    {1920, 1080},
+};
+
+constexpr RgbaPattern kPatterns[] = {
+    RgbaPattern::kFlat,
+    RgbaPattern::kGradient,
+    RgbaPattern::kNoise,
+    RgbaPattern::kCamera,
+};
+
+const char* PatternName(RgbaPattern pattern) {
+  switch (pattern) {
+    case RgbaPattern::kFlat:
+      return "flat";
+    case RgbaPattern::kGradient:
+      return "gradient";
+    case RgbaPattern::kNoise:
+      return "noise";
+    case RgbaPattern::kCamera:
+      return "camera";
+  }
+  return "";
+}
+
+std::string Describe(RgbaPattern pattern, ImageSize size) {
+  return std::string(PatternName(pattern)) + " " +
+         std::to_string(size.width) + "x" + std::to_string(size.height);
+}
+
+// The RGB bytes of |rgba|, packed.
+std::vector<uint8_t> ToRgb(const std::vector<uint8_t>& rgba,
+                           int width,
+                           int height,
+                           int stride) {
+  std::vector<uint8_t> rgb;
+  rgb.reserve(size_t(width) * height * 3);
+  for (int y = 0; y < height; y++) {
+    const uint8_t* row = rgba.data() + size_t(y) * stride;
+    for (int x = 0; x < width; x++) {
+      rgb.insert(rgb.end(), row + x * 4, row + x * 4 + 3);
+    }
+  }
+  return rgb;
+}
+
+uint32_t ReadBigEndian32(const uint8_t* data) {
+  return uint32_t(data[0]) << 24 | uint32_t(data[1]) << 16 |
+         uint32_t(data[2]) << 8 | data[3];
+}
+
+uint8_t Paeth(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc)
+    return static_cast<uint8_t>(a);
+  return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// A minimal decoder for 8-bit RGB PNGs: checks the signature and every
+// chunk CRC, inflates the IDAT data with zlib and undoes the row filters.
+::testing::AssertionResult DecodePng(const std::vector<uint8_t>& png,
+                                     int* width,
+                                     int* height,
+                                     std::vector<uint8_t>* rgb) {
+  static const uint8_t kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n',
+                                       0x1a, '\n'};
+  if (png.size() < 8 || memcmp(png.data(), kSignature, 8) != 0)
+    return ::testing::AssertionFailure() << "bad signature";
+  std::vector<uint8_t> zdata;
+  bool have_header = false;
+  bool have_end = false;
+  size_t pos = 8;
+  while (!have_end) {
+    if (png.size() - pos < 12)
+      return ::testing::AssertionFailure() << "truncated chunk at " << pos;
+    uint32_t length = ReadBigEndian32(&png[pos]);
+    if (png.size() - pos - 12 < length)
+      return ::testing::AssertionFailure() << "chunk overruns the file";
+    const uint8_t* type = &png[pos + 4];
+    const uint8_t* data = type + 4;
+    uint32_t crc = uint32_t(crc32(0, type, length + 4));
+    if (crc != ReadBigEndian32(data + length))
+      return ::testing::AssertionFailure() << "bad CRC at " << pos;
+    std::string name(reinterpret_cast<const char*>(type), 4);
+    if (name == "IHDR") {
+      static const uint8_t kRgb8[] = {8, 2, 0, 0, 0};
+      if (length != 13 || memcmp(data + 8, kRgb8, 5) != 0)
+        return ::testing::AssertionFailure() << "not an 8-bit RGB image";
+      *width = int(ReadBigEndian32(data));
+      *height = int(ReadBigEndian32(data + 4));
+      have_header = true;
+    } else if (name == "IDAT") {
+      zdata.insert(zdata.end(), data, data + length);
+    } else if (name == "IEND") {
+      have_end = true;
+    }
+    pos += 12 + length;
+  }
+  if (!have_header)
+    return ::testing::AssertionFailure() << "no IHDR";
+  if (pos != png.size())
+    return ::testing::AssertionFailure() << "data after IEND";
+
+  size_t row_bytes = size_t(*width) * 3;
+  std::vector<uint8_t> filtered((row_bytes + 1) * *height);
+  uLongf filtered_size = uLongf(filtered.size());
+  int status = uncompress(filtered.data(), &filtered_size, zdata.data(),
+                          uLong(zdata.size()));
+  if (status != Z_OK)
+    return ::testing::AssertionFailure() << "inflate failed: " << status;
+  if (filtered_size != filtered.size())
+    return ::testing::AssertionFailure()
+           << "inflated to " << filtered_size << " bytes, expected "
+           << filtered.size();
+
+  rgb->assign(row_bytes * *height, 0);
+  std::vector<uint8_t> zero_row(row_bytes, 0);
+  for (int y = 0; y < *height; y++) {
+    const uint8_t* in = &filtered[(row_bytes + 1) * y];
+    uint8_t* out = rgb->data() + row_bytes * y;
+    const uint8_t* up = y > 0 ? out - row_bytes : zero_row.data();
+    for (size_t i = 0; i < row_bytes; i++) {
+      int a = i >= 3 ? out[i - 3] : 0;
+      int b = up[i];
+      int c = i >= 3 ? up[i - 3] : 0;
+      int predictor;
+      switch (in[0]) {
+        case 0:
+          predictor = 0;
+          break;
+        case 1:
+          predictor = a;
+          break;
+        case 2:
+          predictor = b;
+          break;
+        case 3:
+          predictor = (a + b) / 2;
+          break;
+        case 4:
+          predictor = Paeth(a, b, c);
+          break;
+        default:
+          return ::testing::AssertionFailure()
+                 << "row " << y << " has filter " << int(in[0]);
+      }
+      out[i] = static_cast<uint8_t>(in[1 + i] + predictor);
+    }
+  }
+  return ::testing::AssertionSuccess();
+}
+
+struct JpegErrorManager {
+  jpeg_error_mgr base;
+  char message[JMSG_LENGTH_MAX];
+  bool failed = false;
+};
+
+// Decodes to RGB with libjpeg. Errors are recorded instead of exiting, and
+// libjpeg substitutes dummy data for whatever it could not decode.
+::testing::AssertionResult DecodeJpeg(const std::vector<uint8_t>& jpeg,
+                                      int* width,
+                                      int* height,
+                                      std::vector<uint8_t>* rgb) {
+  jpeg_decompress_struct decoder;
+  JpegErrorManager errors;
+  decoder.err = jpeg_std_error(&errors.base);
+  errors.base.emit_message = [](j_common_ptr info, int level) {
+    JpegErrorManager* errors = reinterpret_cast<JpegErrorManager*>(info->err);
+    if (level < 0 && !errors->failed) {
+      errors->failed = true;
+      errors->base.format_message(info, errors->message);
+    }
+  };
+  errors.base.error_exit = [](j_common_ptr info) {
+    // Unrecoverable errors cannot return to libjpeg; the test is lost.
+    char message[JMSG_LENGTH_MAX];
+    info->err->format_message(info, message);
+    fprintf(stderr, "libjpeg: %s\n", message);
+    abort();
+  };
+  jpeg_create_decompress(&decoder);
+  jpeg_mem_src(&decoder, const_cast<uint8_t*>(jpeg.data()),
+               static_cast<unsigned long>(jpeg.size()));
+  jpeg_read_header(&decoder, TRUE);
+  decoder.out_color_space = JCS_RGB;
+  jpeg_start_decompress(&decoder);
+  *width = int(decoder.output_width);
+  *height = int(decoder.output_height);
+  size_t row_bytes = size_t(*width) * 3;
+  rgb->assign(row_bytes * *height, 0);
+  while (decoder.output_scanline < decoder.output_height) {
+    JSAMPROW row = rgb->data() + row_bytes * decoder.output_scanline;
+    jpeg_read_scanlines(&decoder, &row, 1);
+  }
+  jpeg_finish_decompress(&decoder);
+  jpeg_destroy_decompress(&decoder);
+  if (errors.failed)
+    return ::testing::AssertionFailure() << "libjpeg: " << errors.message;
+  return ::testing::AssertionSuccess();
+}
+
+// libjpeg's own baseline encoding of |rgb|, with its default 4:2:0 chroma.
+std::vector<uint8_t> EncodeWithLibjpeg(const std::vector<uint8_t>& rgb,
+                                       int width,
+                                       int height,
+                                       int quality) {
+  jpeg_compress_struct encoder;
+  jpeg_error_mgr errors;
+  encoder.err = jpeg_std_error(&errors);
+  jpeg_create_compress(&encoder);
+  unsigned char* buffer = nullptr;
+  unsigned long size = 0;
+  jpeg_mem_dest(&encoder, &buffer, &size);
+  encoder.image_width = JDIMENSION(width);
+  encoder.image_height = JDIMENSION(height);
+  encoder.input_components = 3;
+  encoder.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&encoder);
+  jpeg_set_quality(&encoder, quality, TRUE);
+  jpeg_start_compress(&encoder, TRUE);
+  while (encoder.next_scanline < encoder.image_height) {
+    JSAMPROW row = const_cast<uint8_t*>(rgb.data()) +
+                   size_t(width) * 3 * encoder.next_scanline;
+    jpeg_write_scanlines(&encoder, &row, 1);
+  }
+  jpeg_finish_compress(&encoder);
+  std::vector<uint8_t> jpeg(buffer, buffer + size);
+  jpeg_destroy_compress(&encoder);
+  free(buffer);
+  return jpeg;
+}
+
+double Psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+  double squared_error = 0;
+  for (size_t i = 0; i < a.size(); i++) {
+    double difference = double(a[i]) - double(b[i]);
+    squared_error += difference * difference;
+  }
+  if (squared_error == 0)
+    return INFINITY;
+  double mse = squared_error / a.size();
+  return 10 * std::log10(255.0 * 255.0 / mse);
+}
+
+TEST(ImageEncoderTest, PngRoundTripsExactly) {
+  std::mt19937 rng(7);
+  std::vector<uint8_t> png;
+  for (RgbaPattern pattern : kPatterns) {
+    for (ImageSize size : kSizes) {
+      SCOPED_TRACE(Describe(pattern, size));
+      // Padded rows, whose padding must not leak into the image.
+      int stride = size.width * 4 + 8;
+      std::vector<uint8_t> rgba =
+          MakeRgbaImage(pattern, size.width, size.height, stride, &rng);
+      ImageEncodeOptions options;
+      options.format = ImageFormat::kPng;
+      ASSERT_TRUE(EncodeImage(rgba.data(), size.width, size.height, stride,
+                              options, &png));
+      int width = 0;
+      int height = 0;
+      std::vector<uint8_t> decoded;
+      ASSERT_TRUE(DecodePng(png, &width, &height, &decoded));
+      EXPECT_EQ(width, size.width);
+      EXPECT_EQ(height, size.height);
+      EXPECT_TRUE(decoded ==
+                  ToRgb(rgba, size.width, size.height, stride));
+    }
+  }
+}
+
+// 4:2:0 chroma loses detail, most of all in tiny images and colour noise,
+// so fidelity and size are judged against libjpeg at the same quality.
+TEST(ImageEncoderTest, JpegRoundTripsAsWellAsLibjpeg) {
+  std::mt19937 rng(8);
+  std::vector<uint8_t> jpeg;
+  for (RgbaPattern pattern : kPatterns) {
+    for (ImageSize size : kSizes) {
+      SCOPED_TRACE(Describe(pattern, size));
+      int stride = size.width * 4 + 8;
+      std::vector<uint8_t> rgba =
+          MakeRgbaImage(pattern, size.width, size.height, stride, &rng);
+      std::vector<uint8_t> source =
+          ToRgb(rgba, size.width, size.height, stride);
+      ImageEncodeOptions options;
+      options.format = ImageFormat::kJpeg;
+      options.quality = 90;
+      ASSERT_TRUE(EncodeImage(rgba.data(), size.width, size.height, stride,
+                              options, &jpeg));
+      int width = 0;
+      int height = 0;
+      std::vector<uint8_t> decoded;
+      ASSERT_TRUE(DecodeJpeg(jpeg, &width, &height, &decoded));
+      ASSERT_EQ(width, size.width);
+      ASSERT_EQ(height, size.height);
+
+      std::vector<uint8_t> reference =
+          EncodeWithLibjpeg(source, size.width, size.height, 90);
+      std::vector<uint8_t> reference_decoded;
+      ASSERT_TRUE(DecodeJpeg(reference, &width, &height, &reference_decoded));
+      double psnr = Psnr(decoded, source);
+      double reference_psnr = Psnr(reference_decoded, source);
+      // Above 45 dB what is left is the odd unit of rounding, which on
+      // flat colour or a single pixel is all there is. Single pixel rows
+      // and columns also pad their blocks differently. Elsewhere the two
+      // are within a tenth of a decibel and a few percent.
+      EXPECT_GE(psnr, std::min(reference_psnr - 2.0, 45.0));
+      EXPECT_LE(jpeg.size(), reference.size() * 3 / 2);
+    }
+  }
+}
+
+TEST(ImageEncoderTest, JpegQualityTradesSizeForFidelity) {
+  std::mt19937 rng(9);
+  const int width = 320;
+  const int height = 240;
+  std::vector<uint8_t> rgba = MakeRgbaImage(RgbaPattern::kCamera, width,
+                                            height, width * 4, &rng);
+  std::vector<uint8_t> source = ToRgb(rgba, width, height, width * 4);
+  size_t previous_size = 0;
+  double previous_psnr = 0;
+  for (int quality : {10, 50, 90, 100}) {
+    SCOPED_TRACE(quality);
+    ImageEncodeOptions options;
+    options.format = ImageFormat::kJpeg;
+    options.quality = quality;
+    std::vector<uint8_t> jpeg;
+    ASSERT_TRUE(
+        EncodeImage(rgba.data(), width, height, width * 4, options, &jpeg));
+    int decoded_width = 0;
+    int decoded_height = 0;
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(DecodeJpeg(jpeg, &decoded_width, &decoded_height, &decoded));
+    double psnr = Psnr(decoded, source);
+    EXPECT_GT(jpeg.size(), previous_size);
+    EXPECT_GT(psnr, previous_psnr);
+    previous_size = jpeg.size();
+    previous_psnr = psnr;
+  }
+}
+
+TEST(ImageEncoderTest, ReusedOutputIsReplaced) {
+  std::mt19937 rng(10);
+  std::vector<uint8_t> rgba =
+      MakeRgbaImage(RgbaPattern::kGradient, 16, 16, 16 * 4, &rng);
+  ImageEncodeOptions options;
+  std::vector<uint8_t> fresh;
+  ASSERT_TRUE(EncodeImage(rgba.data(), 16, 16, 16 * 4, options, &fresh));
+  std::vector<uint8_t> reused(100000, 0xAB);
+  ASSERT_TRUE(EncodeImage(rgba.data(), 16, 16, 16 * 4, options, &reused));
+  EXPECT_TRUE(reused == fresh);
+}
+
+TEST(ImageEncoderTest, RejectsEmptyImages) {
+  const uint8_t pixel[4] = {1, 2, 3, 255};
+  std::vector<uint8_t> out(10, 0xAB);
+  for (ImageFormat format : {ImageFormat::kPng, ImageFormat::kJpeg}) {
+    ImageEncodeOptions options;
+    options.format = format;
+    EXPECT_FALSE(EncodeImage(pixel, 0, 1, 4, options, &out));
+    EXPECT_FALSE(EncodeImage(pixel, 1, 0, 4, options, &out));
+    EXPECT_FALSE(EncodeImage(nullptr, 1, 1, 4, options, &out));
+    EXPECT_TRUE(out.empty());
+  }
+}
+
+TEST(ImageEncoderTest, FormatNames) {
+  ImageFormat format = ImageFormat::kJpeg;
+  EXPECT_TRUE(ImageFormatFromName("png", &format));
+  EXPECT_EQ(format, ImageFormat::kPng);
+  EXPECT_TRUE(ImageFormatFromName("jpeg", &format));
+  EXPECT_EQ(format, ImageFormat::kJpeg);
+  EXPECT_TRUE(ImageFormatFromName("jpg", &format));
+  EXPECT_EQ(format, ImageFormat::kJpeg);
+  EXPECT_FALSE(ImageFormatFromName("gif", &format));
+}
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
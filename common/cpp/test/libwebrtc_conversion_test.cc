@@ -0,0 +1,93 @@
+// Checks that the plugin's I420 to RGBA conversion produces exactly the
+// bytes RTCVideoFrame::ConvertToARGB (libyuv) did before it replaced it.
+// Needs the libwebrtc library; see LIBWEBRTC_LIBRARY in CMakeLists.txt.
+
+#include "flutter_yuv_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rtc_video_frame.h"
+#include "test_images.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+using libwebrtc::RTCVideoFrame;
+using libwebrtc::scoped_refptr;
+
+struct Layout {
+  RgbaLayout plugin;
+  RTCVideoFrame::Type libwebrtc;
+};
+
+// libyuv names formats by their little-endian word order, so its ABGR is
+// R, G, B, A in memory.
+constexpr Layout kLayouts[] = {
+    {RgbaLayout::kRGBA, RTCVideoFrame::Type::kABGR},
+    {RgbaLayout::kBGRA, RTCVideoFrame::Type::kARGB},
+};
+
+::testing::AssertionResult MatchesLibwebrtc(const std::string& backend,
+                                            const test::TestImage& image,
+                                            const Layout& layout) {
+  const I420Planes& planes = image.planes;
+  scoped_refptr<RTCVideoFrame> frame = RTCVideoFrame::Create(
+      planes.width, planes.height, planes.y, planes.stride_y, planes.u,
+      planes.stride_u, planes.v, planes.stride_v);
+  int dst_stride = planes.width * 4;
+  std::vector<uint8_t> expected(size_t(dst_stride) * planes.height);
+  std::vector<uint8_t> actual(expected.size());
+  frame->ConvertToARGB(layout.libwebrtc, expected.data(), dst_stride,
+                       planes.width, planes.height);
+  // The frame holds its own copy of the planes, with strides of its
+  // choosing.
+  ConvertI420ToRgbaWithBackend(backend, I420PlanesFromFrame(*frame),
+                               layout.plugin, actual.data(), dst_stride);
+  if (expected == actual)
+    return ::testing::AssertionSuccess();
+  for (size_t i = 0;; i++) {
+    if (expected[i] != actual[i]) {
+      return ::testing::AssertionFailure()
+             << backend << " " << planes.width << "x" << planes.height
+             << ": byte " << i << " (row " << i / dst_stride << ", pixel "
+             << (i % dst_stride) / 4 << ") is " << int(actual[i])
+             << ", libwebrtc gives " << int(expected[i]);
+    }
+  }
+}
+
+class LibwebrtcConversionTest : public ::testing::TestWithParam<std::string> {
+};
+
+TEST_P(LibwebrtcConversionTest, EveryYuvTripleMatches) {
+  static const test::TestImage exhaustive = test::MakeExhaustiveImage();
+  for (const Layout& layout : kLayouts) {
+    EXPECT_TRUE(MatchesLibwebrtc(GetParam(), exhaustive, layout));
+  }
+}
+
+TEST_P(LibwebrtcConversionTest, OddAndCommonSizesMatch) {
+  std::mt19937 rng(20240302);
+  for (const Layout& layout : kLayouts) {
+    for (int width : {1, 2, 3, 15, 16, 17, 33, 63, 65, 640, 1280, 1921}) {
+      for (int height : {1, 3, 8, 361}) {
+        test::TestImage image = test::MakeImage(width, height, 0, &rng);
+        EXPECT_TRUE(MatchesLibwebrtc(GetParam(), image, layout));
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllBackends,
+                         LibwebrtcConversionTest,
+                         ::testing::ValuesIn(YuvConverterBackends()),
+                         [](const ::testing::TestParamInfo<std::string>& info) {
+                           return info.param;
+                         });
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
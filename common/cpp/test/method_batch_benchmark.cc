@@ -0,0 +1,149 @@
+// A 50-call connection setup (getUserMedia, createPeerConnection, tracks,
+// offer/answer and a stream of candidates) sent over the method channel
+// as 50 calls, and as one executeBatch call. Handlers reply inline, so
+// what is measured is what batching saves: per-call encoding, decoding,
+// dispatch and platform messages.
+
+#include "flutter_method_batch.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "fake_platform.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+constexpr char kChannel[] = "FlutterWebRTC.Method";
+constexpr int kOperations = 50;
+
+struct Call {
+  std::string method;
+  EncodableValue arguments;
+};
+
+EncodableValue Args(std::initializer_list<std::pair<const char*,
+                                                    EncodableValue>> entries) {
+  EncodableMap map;
+  for (const auto& entry : entries)
+    map[EncodableValue(entry.first)] = entry.second;
+  return EncodableValue(map);
+}
+
+std::vector<Call> CallSetup() {
+  const EncodableValue pc_id("0123456789abcdef0123456789abcdef");
+  const std::string sdp(3000, 'v');
+  std::vector<Call> calls;
+  calls.push_back({"getUserMedia",
+                   Args({{"constraints",
+                          Args({{"audio", EncodableValue(true)},
+                                {"video", EncodableValue(true)}})}})});
+  calls.push_back({"createPeerConnection",
+                   Args({{"configuration", Args({})},
+                         {"constraints", Args({})}})});
+  for (const char* track : {"audio-track-id", "video-track-id"}) {
+    calls.push_back({"addTrack", Args({{"peerConnectionId", pc_id},
+                                       {"trackId", EncodableValue(track)}})});
+  }
+  auto description = [&](const char* type) {
+    return Args({{"peerConnectionId", pc_id},
+                 {"description", Args({{"type", EncodableValue(type)},
+                                       {"sdp", EncodableValue(sdp)}})}});
+  };
+  calls.push_back({"createOffer", Args({{"peerConnectionId", pc_id}})});
+  calls.push_back({"setLocalDescription", description("offer")});
+  calls.push_back({"setRemoteDescription", description("answer")});
+  while (calls.size() < size_t(kOperations)) {
+    calls.push_back(
+        {"addCandidate",
+         Args({{"peerConnectionId", pc_id},
+               {"candidate",
+                Args({{"candidate",
+                       EncodableValue("candidate:842163049 1 udp 1677729535 "
+                                      "203.0.113.7 46154 typ srflx raddr "
+                                      "10.0.0.2 rport 46154 generation 0")},
+                      {"sdpMid", EncodableValue("0")},
+                      {"sdpMLineIndex", EncodableValue(0)}})}})});
+  }
+  return calls;
+}
+
+// Stands in for FlutterWebRTC::Dispatch: every call succeeds at once.
+void Dispatch(const std::string& method_name,
+              const EncodableValue* arguments,
+              std::unique_ptr<MethodResultProxy> result) {
+  EncodableMap reply;
+  reply[EncodableValue("method")] = EncodableValue(method_name);
+  result->Success(EncodableValue(reply));
+}
+
+// As FlutterWebRTCPluginImpl registers its channel.
+class Plugin {
+ public:
+  explicit Plugin(BinaryMessenger* messenger)
+      : channel_(messenger,
+                 kChannel,
+                 &flutter::StandardMethodCodec::GetInstance()) {
+    channel_.SetMethodCallHandler(
+        [this](const MethodCall& call, std::unique_ptr<MethodResult> result) {
+          calls_++;
+          auto proxy = MethodCallProxy::Create(call);
+          auto result_proxy = MethodResultProxy::Create(std::move(result));
+          if (proxy->method_name() != "executeBatch") {
+            Dispatch(proxy->method_name(), proxy->arguments(),
+                     std::move(result_proxy));
+            return;
+          }
+          const ArgView params(proxy->arguments());
+          auto batch = std::make_shared<MethodBatch>(
+              params.List("operations"), params.Boolean("stopOnError"),
+              Dispatch, std::move(result_proxy));
+          batch->Run();
+        });
+  }
+
+  size_t calls() const { return calls_; }
+
+ private:
+  MethodChannel channel_;
+  size_t calls_ = 0;
+};
+
+void BM_CallSetup(benchmark::State& state, bool batched) {
+  test::FakeMessenger messenger;
+  Plugin plugin(&messenger);
+  const std::vector<Call> calls = CallSetup();
+  EncodableList operations;
+  for (const Call& call : calls) {
+    EncodableMap operation;
+    operation[EncodableValue("method")] = EncodableValue(call.method);
+    operation[EncodableValue("args")] = call.arguments;
+    operations.push_back(EncodableValue(operation));
+  }
+  const EncodableValue batch = Args({{"operations", operations}});
+
+  for (auto _ : state) {
+    if (batched) {
+      messenger.InvokeMethod(kChannel, "executeBatch",
+                             std::make_unique<EncodableValue>(batch));
+    } else {
+      for (const Call& call : calls) {
+        messenger.InvokeMethod(
+            kChannel, call.method,
+            std::make_unique<EncodableValue>(call.arguments));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kOperations);
+  state.counters["platform_messages"] =
+      double(plugin.calls()) / state.iterations();
+}
+
+BENCHMARK_CAPTURE(BM_CallSetup, unbatched, false)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_CallSetup, batched, true)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,222 @@
+// executeBatch runs its operations in order, one reply each, on the
+// platform thread, whether handlers reply inline or later from another
+// thread.
+
+#include "flutter_method_batch.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "fake_platform.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+// What a batch replied with, once it has.
+struct Reply {
+  std::optional<EncodableList> outcomes;
+  bool error = false;
+};
+
+class RecordingResult : public MethodResultProxy {
+ public:
+  explicit RecordingResult(Reply* reply) : reply_(reply) {}
+
+  void Success() override { Success(EncodableValue()); }
+  void Success(const EncodableValue& result) override {
+    reply_->outcomes = GetValue<EncodableList>(result);
+  }
+  void Error(const std::string& error_code,
+             const std::string& error_message,
+             const EncodableValue& error_details) override {
+    reply_->error = true;
+  }
+  void Error(const std::string& error_code,
+             const std::string& error_message = "") override {
+    reply_->error = true;
+  }
+  void NotImplemented() override { reply_->error = true; }
+
+ private:
+  Reply* reply_;
+};
+
+EncodableValue Operation(const std::string& method, int argument = 0) {
+  EncodableMap operation;
+  operation[EncodableValue("method")] = EncodableValue(method);
+  operation[EncodableValue("args")] = EncodableValue(argument);
+  return EncodableValue(operation);
+}
+
+const EncodableMap& OutcomeAt(const Reply& reply, size_t index) {
+  return GetValue<EncodableMap>((*reply.outcomes)[index]);
+}
+
+bool Succeeded(const EncodableMap& outcome) {
+  return GetValue<bool>(outcome.at(EncodableValue("success")));
+}
+
+std::string Field(const EncodableMap& outcome, const char* key) {
+  return GetValue<std::string>(outcome.at(EncodableValue(key)));
+}
+
+// Replies inline: "ok" with its argument, "fail" with an error. Records
+// every call it gets.
+class InlineHandlers {
+ public:
+  MethodBatch::Dispatcher dispatcher() {
+    return [this](const std::string& method_name,
+                  const EncodableValue* arguments,
+                  std::unique_ptr<MethodResultProxy> result) {
+      calls_.push_back(method_name);
+      if (method_name == "fail") {
+        result->Error("Failed", "fail() failed");
+      } else {
+        result->Success(*arguments);
+      }
+    };
+  }
+
+  const std::vector<std::string>& calls() const { return calls_; }
+
+ private:
+  std::vector<std::string> calls_;
+};
+
+void RunBatch(EncodableList operations,
+              bool stop_on_error,
+              MethodBatch::Dispatcher dispatcher,
+              Reply* reply) {
+  auto batch = std::make_shared<MethodBatch>(
+      std::move(operations), stop_on_error, std::move(dispatcher),
+      std::make_unique<RecordingResult>(reply));
+  batch->Run();
+}
+
+TEST(MethodBatchTest, RunsOperationsInOrderAndRepliesOnce) {
+  InlineHandlers handlers;
+  Reply reply;
+  RunBatch({Operation("ok", 1), Operation("fail"), Operation("ok", 3)},
+           /*stop_on_error=*/false, handlers.dispatcher(), &reply);
+
+  ASSERT_TRUE(reply.outcomes);
+  EXPECT_FALSE(reply.error);
+  EXPECT_EQ(handlers.calls(), (std::vector<std::string>{"ok", "fail", "ok"}));
+  ASSERT_EQ(reply.outcomes->size(), 3u);
+  EXPECT_TRUE(Succeeded(OutcomeAt(reply, 0)));
+  EXPECT_EQ(OutcomeAt(reply, 0).at(EncodableValue("result")),
+            EncodableValue(1));
+  EXPECT_FALSE(Succeeded(OutcomeAt(reply, 1)));
+  EXPECT_EQ(Field(OutcomeAt(reply, 1), "code"), "Failed");
+  EXPECT_TRUE(Succeeded(OutcomeAt(reply, 2)));
+}
+
+TEST(MethodBatchTest, StopOnErrorSkipsTheRest) {
+  InlineHandlers handlers;
+  Reply reply;
+  RunBatch({Operation("ok"), Operation("fail"), Operation("ok"),
+            Operation("ok")},
+           /*stop_on_error=*/true, handlers.dispatcher(), &reply);
+
+  ASSERT_TRUE(reply.outcomes);
+  EXPECT_EQ(handlers.calls(), (std::vector<std::string>{"ok", "fail"}));
+  ASSERT_EQ(reply.outcomes->size(), 2u);
+  EXPECT_TRUE(Succeeded(OutcomeAt(reply, 0)));
+  EXPECT_FALSE(Succeeded(OutcomeAt(reply, 1)));
+  EXPECT_EQ(Field(OutcomeAt(reply, 1), "method"), "fail");
+}
+
+TEST(MethodBatchTest, NestedExecuteBatchIsRejected) {
+  InlineHandlers handlers;
+  Reply reply;
+  EncodableMap nested;
+  nested[EncodableValue("method")] = EncodableValue("executeBatch");
+  nested[EncodableValue("args")] = EncodableValue(EncodableMap{
+      {EncodableValue("operations"), EncodableValue(EncodableList{
+                                         Operation("ok")})}});
+  RunBatch({Operation("ok"), EncodableValue(nested), Operation("ok")},
+           /*stop_on_error=*/false, handlers.dispatcher(), &reply);
+
+  ASSERT_TRUE(reply.outcomes);
+  // The nested batch never reaches the dispatcher, nor do its operations.
+  EXPECT_EQ(handlers.calls(), (std::vector<std::string>{"ok", "ok"}));
+  ASSERT_EQ(reply.outcomes->size(), 3u);
+  EXPECT_FALSE(Succeeded(OutcomeAt(reply, 1)));
+  EXPECT_EQ(Field(OutcomeAt(reply, 1), "method"), "executeBatch");
+  EXPECT_EQ(Field(OutcomeAt(reply, 1), "code"), "Bad Arguments");
+}
+
+TEST(MethodBatchTest, NestedExecuteBatchStopsTheBatchOnError) {
+  InlineHandlers handlers;
+  Reply reply;
+  RunBatch({Operation("executeBatch"), Operation("ok")},
+           /*stop_on_error=*/true, handlers.dispatcher(), &reply);
+
+  ASSERT_TRUE(reply.outcomes);
+  EXPECT_TRUE(handlers.calls().empty());
+  ASSERT_EQ(reply.outcomes->size(), 1u);
+  EXPECT_FALSE(Succeeded(OutcomeAt(reply, 0)));
+}
+
+TEST(MethodBatchTest, ResultDroppedWithoutReplyIsAnError) {
+  Reply reply;
+  RunBatch({Operation("drop"), Operation("ok")}, /*stop_on_error=*/false,
+           [](const std::string& method_name, const EncodableValue* arguments,
+              std::unique_ptr<MethodResultProxy> result) {
+             if (method_name == "ok")
+               result->Success();
+           },
+           &reply);
+
+  ASSERT_TRUE(reply.outcomes);
+  ASSERT_EQ(reply.outcomes->size(), 2u);
+  EXPECT_EQ(Field(OutcomeAt(reply, 0), "code"), "NoReply");
+  EXPECT_TRUE(Succeeded(OutcomeAt(reply, 1)));
+}
+
+// Handlers that reply from another thread, as libwebrtc's callbacks do:
+// the next operation must wait for the reply and run on the platform
+// thread.
+TEST(MethodBatchTest, AsyncRepliesResumeOnThePlatformThread) {
+  std::thread::id platform_thread = std::this_thread::get_id();
+  std::unique_ptr<MethodResultProxy> pending;
+  std::vector<int> started;
+  bool off_platform_thread = false;
+  Reply reply;
+  RunBatch({Operation("async", 0), Operation("async", 1),
+            Operation("async", 2)},
+           /*stop_on_error=*/false,
+           [&](const std::string& method_name, const EncodableValue* arguments,
+               std::unique_ptr<MethodResultProxy> result) {
+             off_platform_thread |=
+                 std::this_thread::get_id() != platform_thread;
+             started.push_back(GetValue<int>(*arguments));
+             pending = std::move(result);
+           },
+           &reply);
+
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(pending) << "operation " << i << " did not start";
+    EXPECT_EQ(started.size(), size_t(i + 1));
+    EXPECT_FALSE(reply.outcomes);
+    std::thread([i, result = std::move(pending)]() {
+      result->Success(EncodableValue(i * 10));
+    }).join();
+    test::RunPlatformTasks();
+  }
+
+  ASSERT_TRUE(reply.outcomes);
+  EXPECT_FALSE(off_platform_thread);
+  EXPECT_EQ(started, (std::vector<int>{0, 1, 2}));
+  ASSERT_EQ(reply.outcomes->size(), 3u);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(OutcomeAt(reply, i).at(EncodableValue("result")),
+              EncodableValue(i * 10));
+  }
+}
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,88 @@
+// Cost of finding the handler for a method call, per method: FindByName's
+// binary search over a table with FlutterWebRTC's method names, against
+// the compare() chain HandleMethodCall used to walk, which tried one name
+// after another.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+#include "flutter_common.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+struct Entry {
+  std::string_view name;
+  int handler;
+};
+
+// Generated from kMethodHandlers in flutter_webrtc.cc; see CMakeLists.txt.
+constexpr std::string_view kMethodNames[] = {
+#include "method_names.inc"
+};
+constexpr size_t kMethodCount = std::size(kMethodNames);
+
+struct Table {
+  Entry entries[kMethodCount];
+};
+
+constexpr Table MakeTable() {
+  Table table{};
+  for (size_t i = 0; i < kMethodCount; i++)
+    table.entries[i] = {kMethodNames[i], int(i)};
+  return table;
+}
+
+constexpr Table kTable = MakeTable();
+static_assert(IsSortedByName(kTable.entries),
+              "method names must come out of flutter_webrtc.cc sorted");
+
+int FindInTable(const std::string& method_name) {
+  const Entry* entry = FindByName(kTable.entries, method_name);
+  return entry ? entry->handler : -1;
+}
+
+int FindInCompareChain(const std::string& method_name) {
+  for (size_t i = 0; i < kMethodCount; i++) {
+    if (method_name.compare(kMethodNames[i]) == 0)
+      return int(i);
+  }
+  return -1;
+}
+
+void BM_Dispatch(benchmark::State& state,
+                 int (*find)(const std::string&),
+                 std::string method_name) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(method_name);
+    benchmark::DoNotOptimize(find(method_name));
+  }
+}
+
+const bool kRegistered = [] {
+  struct {
+    const char* name;
+    int (*find)(const std::string&);
+  } finders[] = {
+      {"table", FindInTable},
+      {"compare_chain", FindInCompareChain},
+  };
+  for (const auto& finder : finders) {
+    for (std::string_view method : kMethodNames) {
+      std::string name = std::string("Dispatch/") + finder.name + "/" +
+                         std::string(method);
+      benchmark::RegisterBenchmark(name.c_str(), BM_Dispatch, finder.find,
+                                   std::string(method));
+    }
+    // Frame cryptor methods miss this table before reaching their own.
+    std::string name = std::string("Dispatch/") + finder.name + "/<unknown>";
+    benchmark::RegisterBenchmark(name.c_str(), BM_Dispatch, finder.find,
+                                 "frameCryptorFactoryCreateFrameCryptor");
+  }
+  return true;
+}();
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,156 @@
+#ifndef FLUTTER_WEBRTC_TEST_IMAGES_H_
+#define FLUTTER_WEBRTC_TEST_IMAGES_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "flutter_yuv_converter.h"
+
+namespace flutter_webrtc_plugin {
+namespace test {
+
+// I420 planes together with the memory they point into.
+struct TestImage {
+  TestImage() = default;
+  TestImage(const TestImage&) = delete;
+  TestImage& operator=(const TestImage&) = delete;
+  TestImage(TestImage&&) = default;
+  TestImage& operator=(TestImage&&) = default;
+
+  std::vector<uint8_t> y, u, v;
+  I420Planes planes;
+};
+
+// Planes with |padding| spare bytes at the end of every row, so strides
+// differ from widths. Values are mostly the extremes, where clamping and
+// rounding differ first.
+inline TestImage MakeImage(int width,
+                           int height,
+                           int padding,
+                           std::mt19937* rng) {
+  TestImage image;
+  int chroma_width = (width + 1) / 2;
+  int chroma_height = (height + 1) / 2;
+  image.planes.width = width;
+  image.planes.height = height;
+  image.planes.stride_y = width + padding;
+  image.planes.stride_u = chroma_width + padding;
+  image.planes.stride_v = chroma_width + padding;
+  image.y.resize(size_t(image.planes.stride_y) * height);
+  image.u.resize(size_t(image.planes.stride_u) * chroma_height);
+  image.v.resize(size_t(image.planes.stride_v) * chroma_height);
+  std::uniform_int_distribution<int> pick(0, 7);
+  std::uniform_int_distribution<int> any(0, 255);
+  auto fill = [&](std::vector<uint8_t>* plane) {
+    for (uint8_t& value : *plane) {
+      int choice = pick(*rng);
+      value = static_cast<uint8_t>(choice == 0   ? 0
+                                   : choice == 1 ? 255
+                                   : choice == 2 ? 16
+                                   : choice == 3 ? 235
+                                                 : any(*rng));
+    }
+  };
+  fill(&image.y);
+  fill(&image.u);
+  fill(&image.v);
+  image.planes.y = image.y.data();
+  image.planes.u = image.u.data();
+  image.planes.v = image.v.data();
+  return image;
+}
+
+// Every (Y, U, V) triple: a 512 x 65536 image whose pixel pairs share one
+// chroma sample, with Y along the row and (U, V) down the rows.
+inline TestImage MakeExhaustiveImage() {
+  TestImage image;
+  const int width = 512;
+  const int height = 256 * 256;
+  image.planes.width = width;
+  image.planes.height = height;
+  image.planes.stride_y = width;
+  image.planes.stride_u = width / 2;
+  image.planes.stride_v = width / 2;
+  image.y.resize(size_t(width) * height);
+  image.u.resize(size_t(width / 2) * (height / 2));
+  image.v.resize(size_t(width / 2) * (height / 2));
+  for (int row = 0; row < height; row++) {
+    for (int x = 0; x < width; x++) {
+      image.y[size_t(row) * width + x] = static_cast<uint8_t>(x / 2);
+    }
+  }
+  for (int row = 0; row < height / 2; row++) {
+    for (int x = 0; x < width / 2; x++) {
+      image.u[size_t(row) * (width / 2) + x] = static_cast<uint8_t>(row);
+      image.v[size_t(row) * (width / 2) + x] = static_cast<uint8_t>(row >> 8);
+    }
+  }
+  image.planes.y = image.y.data();
+  image.planes.u = image.u.data();
+  image.planes.v = image.v.data();
+  return image;
+}
+
+enum class RgbaPattern {
+  // One colour; every row is a run of maximal deflate matches.
+  kFlat,
+  // Smooth horizontal and vertical ramps.
+  kGradient,
+  // Independent random bytes, which compress not at all.
+  kNoise,
+  // Ramps with a little per-pixel noise, roughly like camera output.
+  kCamera,
+};
+
+// An RGBA image with |stride| bytes per row. Bytes past the end of each row
+// are garbage, to catch encoders that read them.
+inline std::vector<uint8_t> MakeRgbaImage(RgbaPattern pattern,
+                                          int width,
+                                          int height,
+                                          int stride,
+                                          std::mt19937* rng) {
+  std::vector<uint8_t> image(size_t(stride) * height);
+  std::uniform_int_distribution<int> any(0, 255);
+  std::uniform_int_distribution<int> grain(-8, 8);
+  for (uint8_t& value : image) {
+    value = static_cast<uint8_t>(any(*rng));
+  }
+  for (int y = 0; y < height; y++) {
+    uint8_t* row = image.data() + size_t(y) * stride;
+    for (int x = 0; x < width; x++) {
+      uint8_t* pixel = row + x * 4;
+      int r = x * 255 / std::max(width - 1, 1);
+      int g = y * 255 / std::max(height - 1, 1);
+      int b = (r + g) / 2;
+      switch (pattern) {
+        case RgbaPattern::kFlat:
+          r = 40;
+          g = 120;
+          b = 200;
+          break;
+        case RgbaPattern::kGradient:
+          break;
+        case RgbaPattern::kNoise:
+          continue;
+        case RgbaPattern::kCamera:
+          r += grain(*rng);
+          g += grain(*rng);
+          b += grain(*rng);
+          break;
+      }
+      pixel[0] = static_cast<uint8_t>(std::clamp(r, 0, 255));
+      pixel[1] = static_cast<uint8_t>(std::clamp(g, 0, 255));
+      pixel[2] = static_cast<uint8_t>(std::clamp(b, 0, 255));
+      pixel[3] = 255;
+    }
+  }
+  return image;
+}
+
+}  // namespace test
+}  // namespace flutter_webrtc_plugin
+
+#endif  // FLUTTER_WEBRTC_TEST_IMAGES_H_
@@ -0,0 +1,11 @@
+#include <gtest/gtest.h>
+
+#include "flutter_common.h"
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  // As plugin registration does: the thread running the tests plays the
+  // platform thread, and RunPlatformTasks() is its event loop.
+  TaskRunner::InitializePlatform();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+// I420 to RGBA throughput of every conversion path this CPU can run, at the
+// common video sizes; what the renderer's banded conversion costs per
+// 1080p60 frame; what rotating adds; and how 4K latency falls with threads.
+
+#include "flutter_yuv_converter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flutter_worker_pool.h"
+#include "test_images.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+struct FrameSize {
+  const char* name;
+  int width;
+  int height;
+};
+
+constexpr FrameSize kFrameSizes[] = {
+    {"720p", 1280, 720},
+    {"1080p", 1920, 1080},
+    {"4k", 3840, 2160},
+};
+
+void BM_ConvertI420ToRgba(benchmark::State& state,
+                          const std::string& backend,
+                          FrameSize size) {
+  std::mt19937 rng(1);
+  test::TestImage image = test::MakeImage(size.width, size.height, 0, &rng);
+  std::vector<uint8_t> rgba(size_t(size.width) * size.height * 4);
+  for (auto _ : state) {
+    ConvertI420ToRgbaWithBackend(backend, image.planes, RgbaLayout::kRGBA,
+                                 rgba.data(), size.width * 4);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * int64_t(rgba.size()));
+}
+
+// ConvertI420ToRgbaBands into a renderer-sized buffer, |bands| at a time on
+// |pool|. Reports the time per frame and, for |frame_rate| > 0, the share
+// of the frame interval it takes up.
+void ConvertBands(benchmark::State& state,
+                  FrameSize size,
+                  RTCVideoFrame::VideoRotation rotation,
+                  size_t bands,
+                  WorkerPool* pool,
+                  int frame_rate) {
+  std::mt19937 rng(1);
+  test::TestImage image = test::MakeImage(size.width, size.height, 0, &rng);
+  bool swap_sides = rotation == RTCVideoFrame::kVideoRotation_90 ||
+                    rotation == RTCVideoFrame::kVideoRotation_270;
+  int dst_width = swap_sides ? size.height : size.width;
+  std::vector<uint8_t> rgba(size_t(size.width) * size.height * 4);
+  I420BandScratch scratch;
+  for (auto _ : state) {
+    ConvertI420ToRgbaBands(image.planes, size.width, size.height, rotation,
+                           bands, pool, RgbaLayout::kRGBA, rgba.data(),
+                           dst_width * 4, &scratch);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * int64_t(rgba.size()));
+  state.counters["bands"] = double(bands);
+  if (frame_rate > 0) {
+    state.counters["frame_budget"] = benchmark::Counter(
+        1.0 / frame_rate, benchmark::Counter::kIsIterationInvariantRate |
+                                benchmark::Counter::kInvert);
+  }
+}
+
+// A 1080p60 frame as FlutterVideoRenderer converts it by default: one band
+// per shared worker plus the conversion thread. frame_budget is the share
+// of the 16.7 ms frame interval spent converting.
+void BM_Frame1080p60(benchmark::State& state) {
+  WorkerPool* pool = WorkerPool::Shared();
+  ConvertBands(state, {"1080p", 1920, 1080}, RTCVideoFrame::kVideoRotation_0,
+               std::min<size_t>(pool->size() + 1, 1080 / 64), pool, 60);
+}
+
+// One band, so the difference between rotations is the rotate pass alone.
+void BM_Rotation(benchmark::State& state,
+                 FrameSize size,
+                 RTCVideoFrame::VideoRotation rotation) {
+  ConvertBands(state, size, rotation, 1, nullptr, 0);
+}
+
+// A 4K frame split across |threads|: the calling thread and threads - 1
+// workers of a pool of its own.
+void BM_4kThreads(benchmark::State& state) {
+  size_t threads = size_t(state.range(0));
+  WorkerPool pool(std::max<size_t>(threads - 1, 1));
+  ConvertBands(state, {"4k", 3840, 2160}, RTCVideoFrame::kVideoRotation_0,
+               threads, &pool, 0);
+}
+
+BENCHMARK(BM_Frame1080p60)
+    ->Name("ConvertI420ToRgbaBands/1080p60")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_4kThreads)
+    ->Name("ConvertI420ToRgbaBands/4k/threads")
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+const bool kRegistered = [] {
+  for (const std::string& backend : YuvConverterBackends()) {
+    for (const FrameSize& size : kFrameSizes) {
+      benchmark::RegisterBenchmark(
+          ("ConvertI420ToRgba/" + backend + "/" + size.name).c_str(),
+          BM_ConvertI420ToRgba, backend, size)
+          ->Unit(benchmark::kMillisecond);
+    }
+  }
+  struct {
+    const char* name;
+    RTCVideoFrame::VideoRotation rotation;
+  } rotations[] = {
+      {"0", RTCVideoFrame::kVideoRotation_0},
+      {"90", RTCVideoFrame::kVideoRotation_90},
+      {"180", RTCVideoFrame::kVideoRotation_180},
+      {"270", RTCVideoFrame::kVideoRotation_270},
+  };
+  for (const FrameSize& size : {kFrameSizes[0], kFrameSizes[1]}) {
+    for (const auto& rotation : rotations) {
+      benchmark::RegisterBenchmark(
+          (std::string("ConvertI420ToRgbaBands/rotate_") + rotation.name +
+           "/" + size.name)
+              .c_str(),
+          BM_Rotation, size, rotation.rotation)
+          ->Unit(benchmark::kMillisecond);
+    }
+  }
+  return true;
+}();
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -0,0 +1,149 @@
+// Checks that every SIMD I420 to RGBA path this CPU can run produces the
+// same bytes as the scalar path.
+
+#include "flutter_yuv_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flutter_worker_pool.h"
+#include "test_images.h"
+
+namespace flutter_webrtc_plugin {
+namespace {
+
+using test::MakeExhaustiveImage;
+using test::MakeImage;
+using test::TestImage;
+
+std::vector<std::string> SimdBackends() {
+  std::vector<std::string> backends = YuvConverterBackends();
+  backends.pop_back();  // "scalar"
+  return backends;
+}
+
+// Converts |image| with |backend| and the scalar path, into destinations at
+// byte offset |dst_offset| so unaligned stores are covered too, and reports
+// the first differing byte on a mismatch.
+::testing::AssertionResult MatchesScalar(const std::string& backend,
+                                         const I420Planes& image,
+                                         RgbaLayout layout,
+                                         int dst_offset) {
+  int dst_stride = image.width * 4 + 12;
+  size_t size = size_t(dst_stride) * image.height + dst_offset;
+  std::vector<uint8_t> expected(size, 0xAB);
+  std::vector<uint8_t> actual(size, 0xAB);
+  ConvertI420ToRgbaWithBackend("scalar", image, layout,
+                               expected.data() + dst_offset, dst_stride);
+  ConvertI420ToRgbaWithBackend(backend, image, layout,
+                               actual.data() + dst_offset, dst_stride);
+  if (expected == actual)
+    return ::testing::AssertionSuccess();
+  for (size_t i = 0;; i++) {
+    if (expected[i] != actual[i]) {
+      long offset = long(i) - dst_offset;
+      return ::testing::AssertionFailure()
+             << image.width << "x" << image.height << " "
+             << (layout == RgbaLayout::kRGBA ? "rgba" : "bgra") << ": byte "
+             << offset << " (row " << offset / dst_stride << ", pixel "
+             << (offset % dst_stride) / 4 << ") is " << int(actual[i])
+             << ", scalar gives " << int(expected[i]);
+    }
+  }
+}
+
+class YuvConverterTest : public ::testing::TestWithParam<std::string> {};
+
+TEST(YuvConverterBackendsTest, EndWithScalar) {
+  std::vector<std::string> backends = YuvConverterBackends();
+  ASSERT_FALSE(backends.empty());
+  EXPECT_EQ(backends.back(), "scalar");
+  EXPECT_EQ(backends.front(), YuvConverterBackend());
+}
+
+TEST_P(YuvConverterTest, EveryYuvTripleMatchesScalar) {
+  static const TestImage exhaustive = MakeExhaustiveImage();
+  for (RgbaLayout layout : {RgbaLayout::kRGBA, RgbaLayout::kBGRA}) {
+    EXPECT_TRUE(MatchesScalar(GetParam(), exhaustive.planes, layout, 0));
+  }
+}
+
+// Widths around every vector width and its tail, odd heights, padded
+// strides and unaligned destinations.
+TEST_P(YuvConverterTest, SmallSizesMatchScalar) {
+  std::mt19937 rng(20240229);
+  for (RgbaLayout layout : {RgbaLayout::kRGBA, RgbaLayout::kBGRA}) {
+    for (int width = 1; width <= 70; width++) {
+      for (int height : {1, 2, 3, 7}) {
+        TestImage image = MakeImage(width, height, width % 5, &rng);
+        EXPECT_TRUE(
+            MatchesScalar(GetParam(), image.planes, layout, width % 4));
+      }
+    }
+  }
+}
+
+TEST_P(YuvConverterTest, LargeSizesMatchScalar) {
+  std::mt19937 rng(20240301);
+  for (RgbaLayout layout : {RgbaLayout::kRGBA, RgbaLayout::kBGRA}) {
+    for (int size : {320, 641, 1280}) {
+      TestImage image = MakeImage(size, size * 9 / 16 | 1, 32, &rng);
+      EXPECT_TRUE(MatchesScalar(GetParam(), image.planes, layout, 4));
+    }
+  }
+}
+
+// Converting in bands, on a pool or not, gives the bytes a whole-frame
+// scale and rotate does, whatever the rotation and however the rows split.
+TEST(ConvertI420ToRgbaBandsTest, MatchesWholeFrameScaleAndRotate) {
+  std::mt19937 rng(20240612);
+  TestImage image = MakeImage(400, 226, 8, &rng);
+  WorkerPool pool(2);
+  for (auto rotation :
+       {RTCVideoFrame::kVideoRotation_0, RTCVideoFrame::kVideoRotation_90,
+        RTCVideoFrame::kVideoRotation_180,
+        RTCVideoFrame::kVideoRotation_270}) {
+    for (auto size : {std::make_pair(400, 226), std::make_pair(213, 119)}) {
+      int width = size.first, height = size.second;
+      bool swap_sides = rotation == RTCVideoFrame::kVideoRotation_90 ||
+                        rotation == RTCVideoFrame::kVideoRotation_270;
+      int dst_width = swap_sides ? height : width;
+      int dst_stride = dst_width * 4 + 8;
+      size_t dst_size = size_t(dst_stride) * (swap_sides ? width : height);
+
+      I420ScaleScratch scale_scratch;
+      std::vector<uint8_t> scaled(size_t(width) * height * 4);
+      ScaleI420ToRgba(image.planes, width, height, RgbaLayout::kRGBA,
+                      scaled.data(), width * 4, &scale_scratch);
+      std::vector<uint8_t> expected(dst_size, 0xAB);
+      RotateRgba(scaled.data(), width * 4, width, height, rotation,
+                 expected.data(), dst_stride);
+
+      I420BandScratch scratch;
+      for (size_t bands : {1, 2, 3, 4}) {
+        std::vector<uint8_t> actual(dst_size, 0xAB);
+        ConvertI420ToRgbaBands(image.planes, width, height, rotation, bands,
+                               &pool, RgbaLayout::kRGBA, actual.data(),
+                               dst_stride, &scratch);
+        EXPECT_TRUE(actual == expected)
+            << width << "x" << height << " rotated " << int(rotation)
+            << " in " << bands << " bands";
+      }
+    }
+  }
+}
+
+// Only the scalar path exists on CPUs without any of the SIMD extensions.
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(YuvConverterTest);
+INSTANTIATE_TEST_SUITE_P(Simd,
+                         YuvConverterTest,
+                         ::testing::ValuesIn(SimdBackends()),
+                         [](const ::testing::TestParamInfo<std::string>& info) {
+                           return info.param;
+                         });
+
+}  // namespace
+}  // namespace flutter_webrtc_plugin
@@ -2,6 +2,7 @@ import 'dart:async';
 import 'dart:io';
 import 'dart:typed_data';
 
+import 'package:flutter/services.dart';
 import 'package:path_provider/path_provider.dart';
 import 'package:webrtc_interface/webrtc_interface.dart';
 
@@ -85,6 +86,26 @@ class MediaStreamTrackNative extends MediaStreamTrack {
 
   @override
   Future<ByteBuffer> captureFrame() async {
+    // Without a path the Windows and Linux plugin returns the PNG in the
+    // result, sparing a round trip through a temporary file. macOS shares
+    // the darwin plugin, which still needs a path.
+    if (WebRTC.platformIsWindows || WebRTC.platformIsLinux) {
+      try {
+        final response = await WebRTC.invokeMethod(
+          'captureFrame',
+          <String, dynamic>{
+            'trackId': _trackId,
+            'peerConnectionId': _peerConnectionId,
+          },
+        );
+        final Uint8List data = response['data'];
+        // The codec hands back a view into the whole reply; copy out just
+        // the image so the returned buffer holds nothing else.
+        return Uint8List.fromList(data).buffer;
+      } on PlatformException catch (e) {
+        throw 'Unable to MediaStreamTrack::captureFrame: ${e.message}';
+      }
+    }
     var filePath = await getTemporaryDirectory();
     await WebRTC.invokeMethod(
       'captureFrame',
@@ -24,6 +24,7 @@ class RTCDataChannelNative extends RTCDataChannel {
     }
     _eventSubscription = _eventChannelFor(_peerConnectionId, _flutterId)
         .receiveBroadcastStream()
+        .expand(unbatchEvents)
         .listen(eventListener, onError: errorListener);
   }
   final String _peerConnectionId;
@@ -20,6 +20,7 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
   RTCPeerConnectionNative(this._peerConnectionId, this._configuration) {
     _eventSubscription = _eventChannelFor(_peerConnectionId)
         .receiveBroadcastStream()
+        .expand(unbatchEvents)
         .listen(eventListener, onError: errorListener);
   }
 
@@ -161,6 +162,13 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
             cand['candidate'], cand['sdpMid'], cand['sdpMLineIndex']);
         onIceCandidate?.call(candidate);
         break;
+      case 'onCandidates':
+        List<dynamic> candidates = map['candidates'];
+        for (Map<dynamic, dynamic> cand in candidates) {
+          onIceCandidate?.call(RTCIceCandidate(
+              cand['candidate'], cand['sdpMid'], cand['sdpMLineIndex']));
+        }
+        break;
       case 'onAddStream':
         String streamId = map['streamId'];
 
@@ -448,6 +456,37 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
     }
   }
 
+  /// Adds several remote candidates in one native call. Returns one entry
+  /// per candidate, in order: null if it was parsed and submitted to the
+  /// connection, otherwise why it was not. A submitted candidate that the
+  /// connection later discards is not reported.
+  Future<List<String?>> addCandidates(List<RTCIceCandidate> candidates) async {
+    try {
+      final List<dynamic> results =
+          await WebRTC.invokeMethod('addCandidates', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'candidates': candidates.map((c) => c.toMap()).toList(),
+      });
+      return results
+          .map((r) => r['success'] == true ? null : r['error'] as String?)
+          .toList();
+    } on MissingPluginException {
+      // Platforms without the bulk method take them one at a time.
+      final errors = <String?>[];
+      for (var candidate in candidates) {
+        try {
+          await addCandidate(candidate);
+          errors.add(null);
+        } catch (e) {
+          errors.add(e.toString());
+        }
+      }
+      return errors;
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::addCandidates: ${e.message}';
+    }
+  }
+
   @override
   Future<List<StatsReport>> getStats([MediaStreamTrack? track]) async {
     try {
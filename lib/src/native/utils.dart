@@ -57,3 +57,8 @@ class WebRTC {
     }
   }
 }
+
+/// Desktop event channels may deliver several events in one message as a
+/// list; flattens them back into individual events.
+Iterable<dynamic> unbatchEvents(dynamic event) =>
+    event is List ? event : <dynamic>[event];